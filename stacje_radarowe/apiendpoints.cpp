@@ -0,0 +1,78 @@
+#include "apiendpoints.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QSettings>
+
+static QUrl resolve(const QUrl &baseUrl, QString path, int id) {
+    return baseUrl.resolved(QUrl(path.replace("{id}", QString::number(id))));
+}
+
+QUrl ApiEndpoints::stationsUrl() const {
+    return baseUrl.resolved(QUrl(stationsPath));
+}
+
+QUrl ApiEndpoints::sensorsUrl(int stationId) const {
+    return resolve(baseUrl, sensorsPath, stationId);
+}
+
+QUrl ApiEndpoints::dataUrl(int sensorId) const {
+    return resolve(baseUrl, dataPath, sensorId);
+}
+
+void ApiEndpoints::setBaseUrl(const QUrl &url) {
+    baseUrl = url;
+    if (!baseUrl.path().endsWith('/'))
+        baseUrl.setPath(baseUrl.path() + '/');
+}
+
+void ApiEndpoints::loadSettings(const QString &path) {
+    if (path.isEmpty() || !QFile::exists(path)) return;
+
+    QSettings settings(path, QSettings::IniFormat);
+    settings.beginGroup("api");
+    if (settings.contains("base_url")) setBaseUrl(QUrl(settings.value("base_url").toString()));
+    stationsPath = settings.value("stations_path", stationsPath).toString();
+    sensorsPath = settings.value("sensors_path", sensorsPath).toString();
+    dataPath = settings.value("data_path", dataPath).toString();
+    settings.endGroup();
+}
+
+void ApiEndpoints::loadEnvironment() {
+    if (qEnvironmentVariableIsSet("GIOS_API_BASE_URL"))
+        setBaseUrl(QUrl(qEnvironmentVariable("GIOS_API_BASE_URL")));
+    stationsPath = qEnvironmentVariable("GIOS_API_STATIONS_PATH", stationsPath);
+    sensorsPath = qEnvironmentVariable("GIOS_API_SENSORS_PATH", sensorsPath);
+    dataPath = qEnvironmentVariable("GIOS_API_DATA_PATH", dataPath);
+}
+
+void ApiEndpoints::addCommandLineOptions(QCommandLineParser &parser) {
+    parser.addOptions({
+        {"config", "Plik INI z sekcją [api].", "plik"},
+        {"base-url", "Adres bazowy API (proxy, mirror, mock_gios_server).", "url"},
+        {"stations-path", "Ścieżka listy stacji względem adresu bazowego.", "ścieżka"},
+        {"sensors-path", "Ścieżka sensorów stacji ({id} = ID stacji).", "ścieżka"},
+        {"data-path", "Ścieżka danych sensora ({id} = ID sensora).", "ścieżka"},
+    });
+}
+
+ApiEndpoints ApiEndpoints::fromConfiguration(const QCommandLineParser *parser) {
+    ApiEndpoints endpoints;
+
+    QString configPath = QCoreApplication::applicationDirPath() + "/stacje_radarowe.ini";
+    if (qEnvironmentVariableIsSet("GIOS_API_CONFIG"))
+        configPath = qEnvironmentVariable("GIOS_API_CONFIG");
+    if (parser && parser->isSet("config"))
+        configPath = parser->value("config");
+
+    endpoints.loadSettings(configPath);
+    endpoints.loadEnvironment();
+
+    if (parser) {
+        if (parser->isSet("base-url")) endpoints.setBaseUrl(QUrl(parser->value("base-url")));
+        if (parser->isSet("stations-path")) endpoints.stationsPath = parser->value("stations-path");
+        if (parser->isSet("sensors-path")) endpoints.sensorsPath = parser->value("sensors-path");
+        if (parser->isSet("data-path")) endpoints.dataPath = parser->value("data-path");
+    }
+    return endpoints;
+}
@@ -0,0 +1,63 @@
+#ifndef APIENDPOINTS_H
+#define APIENDPOINTS_H
+
+#include <QString>
+#include <QUrl>
+
+class QCommandLineParser;
+
+/**
+ * @struct ApiEndpoints
+ * @brief Adres bazowy i ścieżki endpointów API GIOŚ.
+ *
+ * Pozwala skierować ruch na proxy, lokalny mirror lub serwer testowy. Ścieżki są względne
+ * wobec adresu bazowego (mogą też być pełnymi adresami); "{id}" zastępowane jest ID stacji
+ * lub sensora. Konfiguracja nakłada się w kolejności: wartości domyślne, plik INI
+ * (sekcja [api]), zmienne środowiskowe GIOS_API_*, opcje wiersza poleceń.
+ */
+struct ApiEndpoints {
+    QUrl baseUrl = QUrl("https://api.gios.gov.pl/pjp-api/rest/"); /**< Adres bazowy API. */
+    QString stationsPath = "station/findAll";                       /**< Lista stacji. */
+    QString sensorsPath = "station/sensors/{id}";                   /**< Sensory stacji. */
+    QString dataPath = "data/getData/{id}";                         /**< Dane sensora. */
+
+    QUrl stationsUrl() const;             /**< Pełny adres listy stacji. */
+    QUrl sensorsUrl(int stationId) const; /**< Pełny adres sensorów stacji. */
+    QUrl dataUrl(int sensorId) const;     /**< Pełny adres danych sensora. */
+
+    /**
+     * @brief Ustawia adres bazowy, dopisując końcowy "/" (inaczej ostatni segment byłby zastępowany).
+     * @param url Adres bazowy.
+     */
+    void setBaseUrl(const QUrl &url);
+
+    /**
+     * @brief Nadpisuje pola wartościami z sekcji [api] pliku INI
+     *        (base_url, stations_path, sensors_path, data_path).
+     * @param path Ścieżka pliku; brak pliku nic nie zmienia.
+     */
+    void loadSettings(const QString &path);
+
+    /**
+     * @brief Nadpisuje pola wartościami zmiennych GIOS_API_BASE_URL, GIOS_API_STATIONS_PATH,
+     *        GIOS_API_SENSORS_PATH i GIOS_API_DATA_PATH.
+     */
+    void loadEnvironment();
+
+    /**
+     * @brief Dodaje opcje --config, --base-url, --stations-path, --sensors-path i --data-path.
+     * @param parser Parser wiersza poleceń programu.
+     */
+    static void addCommandLineOptions(QCommandLineParser &parser);
+
+    /**
+     * @brief Buduje konfigurację: domyślne, plik INI, środowisko, wiersz poleceń.
+     *
+     * Plik INI to wartość --config, zmienna GIOS_API_CONFIG albo stacje_radarowe.ini
+     * obok pliku wykonywalnego.
+     * @param parser Przetworzony parser z opcjami z addCommandLineOptions() (może być nullptr).
+     */
+    static ApiEndpoints fromConfiguration(const QCommandLineParser *parser = nullptr);
+};
+
+#endif // APIENDPOINTS_H
@@ -1,97 +1,522 @@
 #include "apiworker.h"
+#include "httpcache.h"
+#include "seriesfile.h"
 #include <QDir>
 #include <QFile>
 #include <QThread>
 #include <QDebug>
+#include <QDateTime>
+#include <QTimer>
+#include <QMetaMethod>
+#include <algorithm>
 
-ApiWorker::ApiWorker(QObject *parent) : QObject(parent) {
+ApiWorker::ApiWorker(QObject *parent) : QObject(parent), random(QRandomGenerator::global()->generate()) {
     manager = new QNetworkAccessManager(this);
+    manager->setCache(new HttpCache("offline/http_cache"));
+    scheduler = new RequestScheduler(this);
+}
+
+void ApiWorker::setEndpoints(const ApiEndpoints &endpoints) {
+    this->endpoints = endpoints;
+}
+
+ApiEndpoints ApiWorker::apiEndpoints() const {
+    return endpoints;
+}
+
+void ApiWorker::setBaseUrl(const QUrl &url) {
+    endpoints.setBaseUrl(url);
+}
+
+void ApiWorker::setStationsCacheMaxAge(qint64 seconds) {
+    if (HttpCache *cache = qobject_cast<HttpCache*>(manager->cache()))
+        cache->setMaxAge(seconds);
+}
+
+/**
+ * @brief Tworzy żądanie do danych zmiennych w czasie (sensory, pomiary), które nie trafiają do cache HTTP.
+ */
+static QNetworkRequest uncachedRequest(const QUrl &url) {
+    QNetworkRequest request(url);
+    request.setAttribute(QNetworkRequest::CacheSaveControlAttribute, false);
+    return request;
 }
 
 void ApiWorker::fetchStations(const QString &city) {
-    currentCity = city;
     qDebug() << "Fetching stations in thread:" << QThread::currentThread();
-    const QNetworkRequest request(QUrl("https://api.gios.gov.pl/pjp-api/rest/station/findAll"));
-    QNetworkReply *reply = manager->get(request);
-    connect(reply, &QNetworkReply::finished, this, &ApiWorker::onStationsFetched);
+    // Lista stacji zmienia się kilka razy w roku - domyślne PreferNetwork serwuje ją z cache,
+    // dopóki wpis jest ważny (HttpCache::setMaxAge), a potem rewaliduje żądaniem warunkowym.
+    // PreferCache pomijałoby datę ważności i nigdy nie pytało API.
+    QNetworkRequest request(endpoints.stationsUrl());
+    RequestContext context;
+    context.city = city;
+    get(request, context, &ApiWorker::onStationsFetched, RequestScheduler::StationsClass);
 }
 
-void ApiWorker::fetchSensors(int stationId) {
-    currentStationId = stationId;
+void ApiWorker::fetchSensors(int stationId, bool supersede, RequestScheduler::Priority priority) {
     qDebug() << "Fetching sensors in thread:" << QThread::currentThread();
-    const QNetworkRequest request(QUrl("https://api.gios.gov.pl/pjp-api/rest/station/sensors/" + QString::number(stationId)));
-    QNetworkReply *reply = manager->get(request);
-    connect(reply, &QNetworkReply::finished, this, &ApiWorker::onSensorsFetched);
+    RequestContext context;
+    context.stationId = stationId;
+    context.priority = priority;
+    if (supersede)
+        this->supersede(SensorsGroup, context);
+    get(uncachedRequest(endpoints.sensorsUrl(stationId)), context, &ApiWorker::onSensorsFetched,
+        RequestScheduler::SensorsClass);
 }
 
-void ApiWorker::fetchData(int sensorId) {
-    currentSensorId = sensorId;
+void ApiWorker::fetchData(int sensorId, qint64 fromMs, qint64 toMs, bool supersede,
+                          RequestScheduler::Priority priority) {
     qDebug() << "Fetching data in thread:" << QThread::currentThread();
-    const QNetworkRequest request(QUrl("https://api.gios.gov.pl/pjp-api/rest/data/getData/" + QString::number(sensorId)));
+    RequestContext context;
+    context.sensorId = sensorId;
+    context.fromMs = fromMs;
+    context.toMs = toMs;
+    context.priority = priority;
+    if (supersede)
+        this->supersede(DataGroup, context);
+    get(uncachedRequest(endpoints.dataUrl(sensorId)), context, &ApiWorker::onDataFetched,
+        RequestScheduler::DataClass);
+}
+
+void ApiWorker::fetchStationSnapshot(int stationId, qint64 fromMs, qint64 toMs,
+                                     RequestScheduler::Priority priority) {
+    qDebug() << "Fetching station snapshot in thread:" << QThread::currentThread();
+    const int snapshotId = ++lastSnapshotId;
+    StationSnapshot &snapshot = snapshots[snapshotId];
+    snapshot.stationId = stationId;
+    snapshot.fromMs = fromMs;
+    snapshot.toMs = toMs;
+
+    RequestContext context;
+    context.stationId = stationId;
+    context.snapshotId = snapshotId;
+    context.priority = priority;
+    get(uncachedRequest(endpoints.sensorsUrl(stationId)), context, &ApiWorker::onSnapshotSensorsFetched,
+        RequestScheduler::SensorsClass);
+}
+
+void ApiWorker::setPrefetchMaxAge(qint64 seconds) {
+    prefetchMaxAgeMs = seconds * 1000;
+}
+
+int ApiWorker::prefetchHitCount() const {
+    return prefetchHits;
+}
+
+void ApiWorker::prefetchStations(const QVector<int> &stationIds) {
+    // Przeterminowane wyniki nie obsłużą już żadnego żądania
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (auto it = prefetched.begin(); it != prefetched.end();) {
+        if (now - it->fetchedAtMs > prefetchMaxAgeMs)
+            it = prefetched.erase(it);
+        else
+            ++it;
+    }
+
+    for (int stationId : stationIds) {
+        const QUrl url = endpoints.sensorsUrl(stationId);
+        if (hasPrefetched(url)) continue;
+        RequestContext context;
+        context.stationId = stationId;
+        context.priority = RequestScheduler::Background;
+        get(uncachedRequest(url), context, &ApiWorker::onPrefetchSensorsFetched, RequestScheduler::SensorsClass);
+    }
+}
+
+bool ApiWorker::isPrefetchHandler(ReplyHandler handler) {
+    return handler == &ApiWorker::onPrefetchSensorsFetched || handler == &ApiWorker::onPrefetchDataFetched;
+}
+
+bool ApiWorker::hasPrefetched(const QUrl &url) const {
+    auto it = prefetched.constFind(url);
+    return it != prefetched.constEnd() && QDateTime::currentMSecsSinceEpoch() - it->fetchedAtMs <= prefetchMaxAgeMs;
+}
+
+void ApiWorker::setRetryPolicy(const RetryPolicy &policy) {
+    retryPolicy = policy;
+    circuitBreaker.setPolicy(policy);
+}
+
+void ApiWorker::setRateLimit(RequestScheduler::EndpointClass endpointClass, double ratePerSecond, int burst) {
+    scheduler->setRateLimit(endpointClass, ratePerSecond, burst);
+}
+
+void ApiWorker::setMaxConcurrent(RequestScheduler::Priority priority, int maxConcurrent) {
+    scheduler->setMaxConcurrent(priority, maxConcurrent);
+}
+
+int ApiWorker::queuedRequestCount() const {
+    return scheduler->queueDepth();
+}
+
+int ApiWorker::retriedRequestCount() const {
+    return retriedCount;
+}
+
+int ApiWorker::abortedRequestCount() const {
+    return abortedCount;
+}
+
+void ApiWorker::supersede(SupersedeGroup group, RequestContext &context) {
+    context.group = group;
+    context.generation = ++generations[group];
+
+    QVector<QNetworkReply *> unused;
+    for (auto it = inFlight.begin(); it != inFlight.end();) {
+        QVector<Waiter> &waiters = it->waiters;
+        waiters.erase(std::remove_if(waiters.begin(), waiters.end(), [&](const Waiter &waiter) {
+            return waiter.context.group == group && waiter.context.generation < context.generation;
+        }), waiters.end());
+
+        // Nikt już nie czeka na wynik - nie ma sensu ściągać reszty odpowiedzi
+        // (żądanie czekające na ponowienie nie ma odpowiedzi - wystarczy je usunąć)
+        if (waiters.isEmpty()) {
+            if (it->reply)
+                unused.append(it->reply);
+            it = inFlight.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // abort() emituje finished() synchronicznie; żądanie jest już usunięte z inFlight,
+    // więc onReplyFinished() tylko zwolni odpowiedź
+    for (QNetworkReply *reply : std::as_const(unused)) {
+        reply->abort();
+        ++abortedCount;
+    }
+}
+
+int ApiWorker::coalescedRequestCount() const {
+    return coalescedCount;
+}
+
+void ApiWorker::get(const QNetworkRequest &request, const RequestContext &context, ReplyHandler handler,
+                    RequestScheduler::EndpointClass endpointClass) {
+    // Identyczne żądanie już w locie - dołączamy do niego zamiast wysyłać drugi GET
+    const QUrl url = request.url();
+
+    // Wynik prefetchu obsługuje jedno żądanie interaktywne; kolejne pobiorą świeże dane
+    if (context.priority == RequestScheduler::Interactive && hasPrefetched(url)) {
+        ApiReply result = prefetched.take(url).reply;
+        result.fromCache = true;
+        ++prefetchHits;
+        (this->*handler)(result, context);
+        return;
+    }
+
+    auto it = inFlight.find(url);
+    if (it != inFlight.end()) {
+        it->waiters.append({context, handler});
+        ++coalescedCount;
+        // Użytkownik czeka na wynik prefetchu - żądanie wyprzedza resztę pracy w tle
+        if (it->queued && context.priority < it->priority) {
+            it->priority = context.priority;
+            schedule(url);
+        }
+        return;
+    }
+
+    InFlightRequest &pending = inFlight[url];
+    pending.request = request;
+    pending.serial = ++lastRequestSerial;
+    pending.endpointClass = endpointClass;
+    pending.priority = context.priority;
+    pending.waiters.append({context, handler});
+    send(url);
+}
+
+void ApiWorker::send(const QUrl &url) {
+    InFlightRequest &pending = inFlight[url];
+    ++pending.attempt;
+
+    // Obwód otwarty - nie obciążamy API, odpowiada cache (albo od razu błąd, jeśli brak wpisu)
+    pending.shortCircuited = !circuitBreaker.allowRequest(url.host(), QDateTime::currentMSecsSinceEpoch());
+    if (pending.shortCircuited) {
+        dispatch(url);
+        return;
+    }
+
+    schedule(url);
+}
+
+void ApiWorker::schedule(const QUrl &url) {
+    // Żądanie czeka na żeton i wolne połączenie; w tym czasie może zostać zastąpione
+    // i usunięte z inFlight albo wysłane z kolejki wyższego priorytetu
+    InFlightRequest &pending = inFlight[url];
+    pending.queued = true;
+    const quint64 serial = pending.serial;
+    const int attempt = pending.attempt;
+    const RequestScheduler::Priority priority = pending.priority;
+    scheduler->enqueue(pending.endpointClass, priority, [this, url, serial, attempt, priority]() {
+        auto it = inFlight.find(url);
+        if (it == inFlight.end() || it->serial != serial || it->attempt != attempt || !it->queued)
+            return false;
+        QNetworkReply *reply = dispatch(url);
+        connect(reply, &QNetworkReply::finished, scheduler, [this, priority]() { scheduler->release(priority); });
+        return true;
+    });
+}
+
+QNetworkReply *ApiWorker::dispatch(const QUrl &url) {
+    InFlightRequest &pending = inFlight[url];
+    pending.queued = false;
+    QNetworkRequest request = pending.request;
+    if (pending.shortCircuited)
+        request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysCache);
+    // Priorytet przekazany też do QNAM, który wybiera z niego kolejne żądanie do wolnego połączenia
+    request.setPriority(pending.priority == RequestScheduler::Interactive ? QNetworkRequest::HighPriority
+                                                                          : QNetworkRequest::LowPriority);
+
     QNetworkReply *reply = manager->get(request);
-    connect(reply, &QNetworkReply::finished, this, &ApiWorker::onDataFetched);
+    pending.reply = reply;
+    connect(reply, &QNetworkReply::finished, this, [this, reply, url]() { onReplyFinished(reply, url); });
+
+    // Dane pomiarowe parsujemy w trakcie pobierania - bez buforowania całej treści i bez DOM
+    pending.stream.reset(pending.endpointClass == RequestScheduler::DataClass ? new SeriesStreamParser : nullptr);
+    if (pending.stream) {
+        connect(reply, &QNetworkReply::readyRead, this, [this, reply, url]() {
+            auto it = inFlight.find(url);
+            if (it != inFlight.end() && it->reply == reply && it->stream && reply->error() == QNetworkReply::NoError)
+                it->stream->feed(reply->readAll());
+        });
+    }
+    return reply;
 }
 
-void ApiWorker::onStationsFetched() {
-    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
-    if (reply->error() != QNetworkReply::NoError) {
-        emit networkError(reply->errorString());
-        reply->deleteLater();
+void ApiWorker::onReplyFinished(QNetworkReply *reply, const QUrl &url) {
+    reply->deleteLater();
+
+    auto it = inFlight.find(url);
+    if (it == inFlight.end() || it->reply != reply) return;
+
+    const QString host = url.host();
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const int httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+    if (!it->shortCircuited) {
+        if (reply->error() != QNetworkReply::NoError && RetryPolicy::isRetryable(reply->error(), httpStatus)) {
+            circuitBreaker.recordFailure(host, now);
+            if (circuitBreaker.isOpen(host, now)) {
+                // Obwód właśnie się otworzył - od razu próbujemy cache
+                send(url);
+                return;
+            }
+            if (it->attempt < retryPolicy.maxAttempts) {
+                // Ponowienie po odczekaniu; nowi odbiorcy dalej dołączają do tego wpisu
+                it->reply = nullptr;
+                const quint64 serial = it->serial;
+                ++retriedCount;
+                QTimer::singleShot(retryPolicy.backoffDelay(it->attempt, random), this, [this, url, serial]() {
+                    auto pending = inFlight.find(url);
+                    if (pending != inFlight.end() && pending->serial == serial && !pending->reply)
+                        send(url);
+                });
+                return;
+            }
+        } else if (reply->error() == QNetworkReply::NoError || (httpStatus > 0 && httpStatus < 500)) {
+            circuitBreaker.recordSuccess(host);
+        }
+    }
+
+    const QVector<Waiter> waiters = it->waiters;
+    const bool shortCircuited = it->shortCircuited;
+    const QSharedPointer<SeriesStreamParser> stream = it->stream;
+    inFlight.erase(it);
+
+    // Treść czytamy raz i przekazujemy wszystkim oczekującym
+    ApiReply result;
+    result.error = reply->error();
+    result.errorString = reply->errorString();
+    if (shortCircuited && result.error != QNetworkReply::NoError)
+        result.errorString = "API unavailable (circuit open) and no cached copy: " + url.toString();
+    result.fromCache = reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool();
+    result.delivered = std::any_of(waiters.cbegin(), waiters.cend(), [](const Waiter &waiter) {
+        return !isPrefetchHandler(waiter.handler);
+    });
+    if (result.error == QNetworkReply::NoError && stream) {
+        stream->feed(reply->readAll());
+        if (stream->finish())
+            result.series = stream->takeSeries();
+        else
+            result.parseError = stream->errorString();
+    } else if (result.error == QNetworkReply::NoError) {
+        result.body = reply->readAll();
+    }
+
+    for (const Waiter &waiter : waiters)
+        (this->*waiter.handler)(result, waiter.context);
+}
+
+bool ApiWorker::parseReply(const ApiReply &reply, QJsonDocument &doc) {
+    if (reply.error != QNetworkReply::NoError) {
+        emit networkError(reply.errorString);
+        return false;
+    }
+
+    QJsonParseError parseError;
+    doc = QJsonDocument::fromJson(reply.body, &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        emit networkError("JSON parsing error: " + parseError.errorString());
+        return false;
+    }
+    return true;
+}
+
+void ApiWorker::writeOfflineFile(const QString &filename, const QJsonDocument &doc) {
+    QDir().mkpath("offline");
+    QFile file(filename);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(doc.toJson());
+        file.close();
+    } else {
+        emit networkError("Failed to write to file: " + filename);
+    }
+}
+
+void ApiWorker::writeOfflineSeries(const MeasurementSeries &series) {
+    const QString filename = SeriesFile::offlinePath(series.sensorId);
+    if (!SeriesFile::merge(filename, series))
+        emit networkError("Failed to write to file: " + filename);
+}
+
+void ApiWorker::onSnapshotSensorsFetched(const ApiReply &reply, const RequestContext &context) {
+    const int snapshotId = context.snapshotId;
+    const int stationId = context.stationId;
+
+    QJsonDocument doc;
+    if (!parseReply(reply, doc)) {
+        snapshots.remove(snapshotId);
+        emit stationSnapshotFailed(stationId);
+        return;
+    }
+    if (!doc.isArray()) {
+        emit networkError("Expected JSON array for sensors");
+        snapshots.remove(snapshotId);
+        emit stationSnapshotFailed(stationId);
+        return;
+    }
+
+    StationSnapshot &snapshot = snapshots[snapshotId];
+    snapshot.sensors = doc.array();
+    writeOfflineFile("offline/sensory_" + QString::number(stationId) + ".json", doc);
+
+    // Wszystkie żądania o dane wysyłamy naraz - czas odświeżenia stacji to jeden
+    // round-trip zamiast liczby sensorów razy round-trip.
+    QVector<int> sensorIds;
+    for (const QJsonValue &val : std::as_const(snapshot.sensors)) {
+        const int sensorId = val.toObject()["id"].toInt();
+        if (sensorId > 0) sensorIds.append(sensorId);
+    }
+    snapshot.pending = sensorIds.size();
+
+    if (snapshot.pending == 0) {
+        emit stationSnapshotFetched(snapshot.sensors, stationId, snapshot.slices);
+        snapshots.remove(snapshotId);
+        return;
+    }
+
+    // Odpowiedź z cache może przyjść synchronicznie, dlatego licznik ustawiamy przed wysłaniem
+    for (int sensorId : std::as_const(sensorIds)) {
+        RequestContext dataContext;
+        dataContext.sensorId = sensorId;
+        dataContext.snapshotId = snapshotId;
+        dataContext.priority = context.priority;
+        get(uncachedRequest(endpoints.dataUrl(sensorId)), dataContext, &ApiWorker::onSnapshotDataFetched,
+            RequestScheduler::DataClass);
+    }
+}
+
+void ApiWorker::onSnapshotDataFetched(const ApiReply &reply, const RequestContext &context) {
+    const int sensorId = context.sensorId;
+
+    auto it = snapshots.find(context.snapshotId);
+    if (it == snapshots.end()) return;
+
+    // Błąd pojedynczego sensora nie przerywa całej migawki - brakujący sensor
+    // po prostu nie pojawi się w wyniku.
+    if (reply.error != QNetworkReply::NoError) {
+        emit networkError(reply.errorString);
+    } else if (!reply.parseError.isEmpty()) {
+        emit networkError("JSON parsing error: " + reply.parseError);
+    } else {
+        MeasurementSeries series = reply.series;
+        series.sensorId = sensorId;
+        it->slices.append(SeriesSlice::make(series, it->fromMs, it->toMs));
+        writeOfflineSeries(series);
+    }
+
+    if (--it->pending == 0) {
+        emit stationSnapshotFetched(it->sensors, it->stationId, it->slices);
+        snapshots.erase(it);
+    }
+}
+
+void ApiWorker::onStationsFetched(const ApiReply &reply, const RequestContext &context) {
+    if (reply.error != QNetworkReply::NoError) {
+        emit networkError(reply.errorString);
+        emit stationsFetchFailed(context.city);
         return;
     }
 
     try {
-        QByteArray response = reply->readAll();
         QJsonParseError parseError;
-        QJsonDocument doc = QJsonDocument::fromJson(response, &parseError);
+        QJsonDocument doc = QJsonDocument::fromJson(reply.body, &parseError);
         if (parseError.error != QJsonParseError::NoError) {
             emit networkError("JSON parsing error: " + parseError.errorString());
-            reply->deleteLater();
+            emit stationsFetchFailed(context.city);
             return;
         }
 
         if (doc.isArray()) {
             QJsonArray stations = doc.array();
-            QDir().mkpath("offline");
-            QFile file("offline/stacje.json");
-            if (file.open(QIODevice::WriteOnly)) {
-                file.write(QJsonDocument(stations).toJson());
-                file.close();
-            } else {
-                emit networkError("Failed to write to file: offline/stacje.json");
+            // Odpowiedź z cache (lub 304) oznacza, że kopia offline jest już aktualna
+            if (!reply.fromCache || !QFile::exists("offline/stacje.json")) {
+                QDir().mkpath("offline");
+                QFile file("offline/stacje.json");
+                if (file.open(QIODevice::WriteOnly)) {
+                    file.write(QJsonDocument(stations).toJson());
+                    file.close();
+                } else {
+                    emit networkError("Failed to write to file: offline/stacje.json");
+                }
             }
-            emit stationsFetched(stations, currentCity);
+            // Katalog budujemy tutaj, w wątku roboczym, i tylko gdy lista faktycznie się zmieniła
+            if (!reply.fromCache || stationCatalog.isEmpty())
+                stationCatalog = StationCatalog::fromJson(stations);
+
+            emit stationsFetched(stations, context.city);
+            emit stationCatalogReady(stationCatalog, context.city);
         } else {
             emit networkError("Expected JSON array for stations");
+            emit stationsFetchFailed(context.city);
         }
     } catch (const std::exception &e) {
         emit networkError("Exception occurred: " + QString(e.what()));
+        emit stationsFetchFailed(context.city);
     }
-
-    reply->deleteLater();
 }
 
-void ApiWorker::onSensorsFetched() {
-    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
-    if (reply->error() != QNetworkReply::NoError) {
-        emit networkError(reply->errorString());
-        reply->deleteLater();
+void ApiWorker::onSensorsFetched(const ApiReply &reply, const RequestContext &context) {
+    if (reply.error != QNetworkReply::NoError) {
+        emit networkError(reply.errorString);
         return;
     }
 
+    const int stationId = context.stationId;
+
     try {
-        QByteArray response = reply->readAll();
         QJsonParseError parseError;
-        QJsonDocument doc = QJsonDocument::fromJson(response, &parseError);
+        QJsonDocument doc = QJsonDocument::fromJson(reply.body, &parseError);
         if (parseError.error != QJsonParseError::NoError) {
             emit networkError("JSON parsing error: " + parseError.errorString());
-            reply->deleteLater();
             return;
         }
 
         if (doc.isArray()) {
             QJsonArray sensors = doc.array();
-            QString filename = "offline/sensory_" + QString::number(currentStationId) + ".json";
+            QDir().mkpath("offline");
+            QString filename = "offline/sensory_" + QString::number(stationId) + ".json";
             QFile file(filename);
             if (file.open(QIODevice::WriteOnly)) {
                 file.write(QJsonDocument(sensors).toJson());
@@ -99,48 +524,61 @@ void ApiWorker::onSensorsFetched() {
             } else {
                 emit networkError("Failed to write to file: " + filename);
             }
-            emit sensorsFetched(sensors, currentStationId);
+            emit sensorsFetched(sensors, stationId);
         } else {
             emit networkError("Expected JSON array for sensors");
         }
     } catch (const std::exception &e) {
         emit networkError("Exception occurred: " + QString(e.what()));
     }
-
-    reply->deleteLater();
 }
 
-void ApiWorker::onDataFetched() {
-    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
-    if (reply->error() != QNetworkReply::NoError) {
-        emit networkError(reply->errorString());
-        reply->deleteLater();
+void ApiWorker::onDataFetched(const ApiReply &reply, const RequestContext &context) {
+    if (reply.error != QNetworkReply::NoError) {
+        emit networkError(reply.errorString);
+        return;
+    }
+    if (!reply.parseError.isEmpty()) {
+        emit networkError("JSON parsing error: " + reply.parseError);
         return;
     }
 
-    try {
-        QByteArray response = reply->readAll();
-        QJsonParseError parseError;
-        QJsonDocument doc = QJsonDocument::fromJson(response, &parseError);
-        if (parseError.error != QJsonParseError::NoError) {
-            emit networkError("JSON parsing error: " + parseError.errorString());
-            reply->deleteLater();
-            return;
-        }
+    const int sensorId = context.sensorId;
 
-        QJsonObject data = doc.object();
-        QString filename = "offline/dane_" + QString::number(currentSensorId) + ".json";
-        QFile file(filename);
-        if (file.open(QIODevice::WriteOnly)) {
-            file.write(doc.toJson());
-            file.close();
-        } else {
-            emit networkError("Failed to write to file: " + filename);
-        }
-        emit dataFetched(data, currentSensorId);
-    } catch (const std::exception &e) {
-        emit networkError("Exception occurred: " + QString(e.what()));
+    // Seria jest już sparsowana w trakcie pobierania; przycięcie do zakresu i statystyki
+    // w wątku roboczym - GUI dostaje gotowy wynik
+    MeasurementSeries series = reply.series;
+    series.sensorId = sensorId;
+    writeOfflineSeries(series);
+    // Obiekt JSON odtwarzamy tylko dla odbiorców dataFetched()
+    if (isSignalConnected(QMetaMethod::fromSignal(&ApiWorker::dataFetched)))
+        emit dataFetched(series.toJson(), sensorId);
+    emit seriesFetched(SeriesSlice::make(series, context.fromMs, context.toMs));
+}
+
+void ApiWorker::onPrefetchSensorsFetched(const ApiReply &reply, const RequestContext &context) {
+    // Prefetch jest tylko przyspieszeniem - błędy zgłosi dopiero żądanie użytkownika
+    if (reply.error != QNetworkReply::NoError) return;
+
+    const QJsonDocument doc = QJsonDocument::fromJson(reply.body);
+    if (!doc.isArray()) return;
+    // Użytkownik dostał już tę odpowiedź (dołączył do prefetchu) - jego następne odświeżenie
+    // musi pójść do API; dane sensorów nadal warto przygotować
+    if (!reply.delivered)
+        prefetched.insert(endpoints.sensorsUrl(context.stationId), {reply, QDateTime::currentMSecsSinceEpoch()});
+
+    for (const QJsonValue &val : doc.array()) {
+        const int sensorId = val.toObject()["id"].toInt();
+        const QUrl url = endpoints.dataUrl(sensorId);
+        if (sensorId <= 0 || hasPrefetched(url)) continue;
+        RequestContext dataContext;
+        dataContext.sensorId = sensorId;
+        dataContext.priority = RequestScheduler::Background;
+        get(uncachedRequest(url), dataContext, &ApiWorker::onPrefetchDataFetched, RequestScheduler::DataClass);
     }
+}
 
-    reply->deleteLater();
+void ApiWorker::onPrefetchDataFetched(const ApiReply &reply, const RequestContext &context) {
+    if (reply.error != QNetworkReply::NoError || !reply.parseError.isEmpty() || reply.delivered) return;
+    prefetched.insert(endpoints.dataUrl(context.sensorId), {reply, QDateTime::currentMSecsSinceEpoch()});
 }
@@ -12,6 +12,14 @@
 #include <QDir>
 #include <QFile>
 #include <QThread>
+#include <QHash>
+#include <QSharedPointer>
+#include "apiendpoints.h"
+#include "requestscheduler.h"
+#include "retrypolicy.h"
+#include "stationcatalog.h"
+#include "measurementseries.h"
+#include "seriesstreamparser.h"
 
 /**
  * @class ApiWorker
@@ -20,6 +28,14 @@
  * ApiWorker zarządza żądaniami sieciowymi do API GIOŚ, zapisuje dane do plików offline
  * i emituje sygnały z pobranymi danymi w formacie JSON. Działa w osobnym wątku QThread,
  * aby nie blokować GUI.
+ *
+ * Kontekst każdego żądania (miasto, ID stacji, ID sensora) jest przechowywany razem
+ * z żądaniem w locie, dzięki czemu wiele żądań może trwać jednocześnie, a odpowiedzi
+ * są przypisywane do właściwych identyfikatorów. Drugie żądanie o ten sam adres, gdy
+ * pierwsze jeszcze trwa, nie wysyła nowego GET - dostaje ten sam wynik.
+ *
+ * Stan żądań nie jest chroniony muteksem: metody wywołuje się wyłącznie w wątku obiektu,
+ * z innego wątku przez QMetaObject::invokeMethod(..., Qt::QueuedConnection).
  */
 class ApiWorker : public QObject {
     Q_OBJECT
@@ -35,6 +51,95 @@ public:
      */
     QNetworkAccessManager *manager;
 
+    /**
+     * Ogranicznik tempa żądań (limity klas endpointów, głębokość kolejek)
+     */
+    RequestScheduler *scheduler;
+
+    /**
+     * @brief Ustawia adres bazowy i ścieżki endpointów API (proxy, mirror, serwer testowy).
+     * @param endpoints Konfiguracja endpointów.
+     */
+    void setEndpoints(const ApiEndpoints &endpoints);
+
+    /**
+     * @brief Zwraca konfigurację endpointów API.
+     */
+    ApiEndpoints apiEndpoints() const;
+
+    /**
+     * @brief Ustawia sam adres bazowy API, zostawiając ścieżki endpointów.
+     * @param url Adres, do którego dopisywane są ścieżki endpointów.
+     */
+    void setBaseUrl(const QUrl &url);
+
+    /**
+     * @brief Ustawia politykę ponawiania i progi wyłącznika obwodu.
+     * @param policy Polityka ponawiania.
+     */
+    void setRetryPolicy(const RetryPolicy &policy);
+
+    /**
+     * @brief Ustawia limit tempa żądań do klasy endpointów API.
+     * @param endpointClass Klasa endpointu.
+     * @param ratePerSecond Średnia liczba żądań na sekundę.
+     * @param burst Liczba żądań, które mogą pójść naraz po okresie bezczynności.
+     */
+    void setRateLimit(RequestScheduler::EndpointClass endpointClass, double ratePerSecond, int burst);
+
+    /**
+     * @brief Ustawia limit równoczesnych połączeń dla priorytetu żądań.
+     * @param priority Priorytet.
+     * @param maxConcurrent Największa liczba żądań priorytetu w locie.
+     */
+    void setMaxConcurrent(RequestScheduler::Priority priority, int maxConcurrent);
+
+    /**
+     * @brief Liczba żądań czekających w ograniczniku tempa na wysłanie.
+     */
+    int queuedRequestCount() const;
+
+    /**
+     * @brief Liczba ponowionych prób po błędach przejściowych.
+     */
+    int retriedRequestCount() const;
+
+    /**
+     * @brief Liczba żądań przerwanych, bo zastąpiło je nowsze żądanie tego samego rodzaju.
+     */
+    int abortedRequestCount() const;
+
+    /**
+     * @brief Liczba żądań, które zamiast osobnego GET dołączyły do identycznego żądania w locie.
+     */
+    int coalescedRequestCount() const;
+
+    /**
+     * @brief Ustawia czas, przez jaki lista stacji jest serwowana z lokalnego cache bez rewalidacji.
+     * @param seconds Czas w sekundach (domyślnie doba).
+     */
+    void setStationsCacheMaxAge(qint64 seconds);
+
+    /**
+     * @brief Ustawia czas, przez jaki wynik prefetchu może obsłużyć żądanie interaktywne.
+     * @param seconds Czas w sekundach (domyślnie 10 minut).
+     */
+    void setPrefetchMaxAge(qint64 seconds);
+
+    /**
+     * @brief Liczba żądań interaktywnych obsłużonych z wyników prefetchu.
+     */
+    int prefetchHitCount() const;
+
+    /**
+     * @brief Pobiera w tle sensory i dane stacji, które użytkownik prawdopodobnie wybierze.
+     *
+     * Odpowiedzi są trzymane w pamięci przez setPrefetchMaxAge(); pierwsze interaktywne
+     * fetchSensors()/fetchData() o ten sam adres dostaje wynik od razu, bez żądania do API.
+     * @param stationIds Stacje do przygotowania, od najbardziej prawdopodobnej.
+     */
+    void prefetchStations(const QVector<int> &stationIds);
+
     /**
      * @brief Pobiera listę stacji pomiarowych.
      * @param city Nazwa miasta, dla którego pobierane są stacje.
@@ -44,14 +149,44 @@ public:
     /**
      * @brief Pobiera listę sensorów dla danej stacji.
      * @param stationId Identyfikator stacji pomiarowej.
+     * @param supersede Czy wcześniejsze, niezakończone fetchSensors(..., true) są nieaktualne
+     *                  (zmiana wyboru stacji) - ich żądania są przerywane, a wyniki pomijane.
+     * @param priority Priorytet żądania (Background dla prefetchu i synchronizacji).
      */
-    void fetchSensors(int stationId);
+    void fetchSensors(int stationId, bool supersede = false,
+                      RequestScheduler::Priority priority = RequestScheduler::Interactive);
 
     /**
      * @brief Pobiera dane pomiarowe dla danego sensora.
+     *
+     * Oprócz dataFetched() emituje seriesFetched() z serią przyciętą do zakresu
+     * [fromMs, toMs] i policzonymi statystykami.
      * @param sensorId Identyfikator sensora.
+     * @param fromMs Początek zakresu dat w ms od epoki (domyślnie bez ograniczenia).
+     * @param toMs Koniec zakresu dat w ms od epoki (domyślnie bez ograniczenia).
+     * @param supersede Czy wcześniejsze, niezakończone fetchData(..., true) są nieaktualne.
+     * @param priority Priorytet żądania (Background dla prefetchu i synchronizacji).
      */
-    void fetchData(int sensorId);
+    void fetchData(int sensorId,
+                   qint64 fromMs = std::numeric_limits<qint64>::min(),
+                   qint64 toMs = std::numeric_limits<qint64>::max(),
+                   bool supersede = false,
+                   RequestScheduler::Priority priority = RequestScheduler::Interactive);
+
+    /**
+     * @brief Pobiera listę sensorów stacji, a następnie równolegle dane wszystkich sensorów.
+     *
+     * Po zakończeniu wszystkich żądań emitowany jest jeden sygnał stationSnapshotFetched()
+     * z kompletem serii pomiarowych stacji.
+     * @param stationId Identyfikator stacji pomiarowej.
+     * @param fromMs Początek zakresu dat serii w ms od epoki (domyślnie bez ograniczenia).
+     * @param toMs Koniec zakresu dat serii w ms od epoki (domyślnie bez ograniczenia).
+     * @param priority Priorytet żądań migawki (Background dla synchronizacji archiwum).
+     */
+    void fetchStationSnapshot(int stationId,
+                              qint64 fromMs = std::numeric_limits<qint64>::min(),
+                              qint64 toMs = std::numeric_limits<qint64>::max(),
+                              RequestScheduler::Priority priority = RequestScheduler::Interactive);
 
 signals:
     /**
@@ -61,6 +196,21 @@ signals:
      */
     void stationsFetched(const QJsonArray &stations, const QString &city);
 
+    /**
+     * @brief Sygnał emitowany po pobraniu stacji, z gotowym indeksowanym katalogiem.
+     * @param catalog Katalog stacji zbudowany z listy station/findAll.
+     * @param city Miasto, dla którego pobrano stacje.
+     */
+    void stationCatalogReady(const StationCatalog &catalog, const QString &city);
+
+    /**
+     * @brief Sygnał emitowany, gdy listy stacji nie da się pobrać (błąd sieci lub odpowiedzi).
+     *
+     * Poprzedza go networkError() z opisem błędu.
+     * @param city Miasto, dla którego pobierano stacje.
+     */
+    void stationsFetchFailed(const QString &city);
+
     /**
      * @brief Sygnał emitowany po pobraniu sensorów.
      * @param sensors Tablica JSON z danymi sensorów.
@@ -75,32 +225,256 @@ signals:
      */
     void dataFetched(const QJsonObject &data, int sensorId);
 
+    /**
+     * @brief Sygnał emitowany po pobraniu danych wszystkich sensorów stacji.
+     * @param sensors Tablica JSON z danymi sensorów.
+     * @param stationId Identyfikator stacji.
+     * @param slices Serie sensorów przycięte do zakresu dat, ze statystykami.
+     */
+    void stationSnapshotFetched(const QJsonArray &sensors, int stationId, const QVector<SeriesSlice> &slices);
+
+    /**
+     * @brief Sygnał emitowany, gdy migawki stacji nie da się pobrać (błąd listy sensorów).
+     *
+     * Poprzedza go networkError() z opisem błędu.
+     * @param stationId Identyfikator stacji.
+     */
+    void stationSnapshotFailed(int stationId);
+
+    /**
+     * @brief Sygnał emitowany po pobraniu danych sensora, z serią gotową do wyświetlenia.
+     * @param slice Seria przycięta do zakresu dat wraz ze statystykami.
+     */
+    void seriesFetched(const SeriesSlice &slice);
+
     /**
      * @brief Sygnał emitowany w przypadku błędu sieciowego.
      * @param errorString Opis błędu.
      */
     void networkError(const QString &errorString);
 
-private slots:
+private:
     /**
-     * @brief Slot obsługujący zakończenie pobierania stacji.
+     * @brief Rodzaj żądań, z których ważne jest tylko najnowsze (zastępowane przy zmianie wyboru).
      */
-    void onStationsFetched();
+    enum SupersedeGroup {
+        NoGroup = 0,  /**< Żądanie nigdy nie jest zastępowane. */
+        SensorsGroup, /**< Sensory wybranej stacji. */
+        DataGroup,    /**< Dane wybranego sensora. */
+        GroupCount
+    };
 
     /**
-     * @brief Slot obsługujący zakończenie pobierania sensorów.
+     * @brief Kontekst żądania: identyfikatory, do których należy odpowiedź.
      */
-    void onSensorsFetched();
+    struct RequestContext {
+        QString city;       /**< Miasto (lista stacji). */
+        int stationId = 0;  /**< Identyfikator stacji. */
+        int sensorId = 0;   /**< Identyfikator sensora. */
+        int snapshotId = 0; /**< Identyfikator migawki stacji. */
+        SupersedeGroup group = NoGroup; /**< Rodzaj żądania zastępowanego przez nowsze. */
+        quint64 generation = 0;         /**< Generacja w grupie w chwili wysłania. */
+        qint64 fromMs = std::numeric_limits<qint64>::min(); /**< Początek zakresu dat serii. */
+        qint64 toMs = std::numeric_limits<qint64>::max();   /**< Koniec zakresu dat serii. */
+        RequestScheduler::Priority priority = RequestScheduler::Interactive; /**< Priorytet żądania. */
+    };
 
     /**
-     * @brief Slot obsługujący zakończenie pobierania danych pomiarowych.
+     * @brief Wynik zakończonego żądania, odczytany z QNetworkReply jeden raz.
      */
-    void onDataFetched();
+    struct ApiReply {
+        QNetworkReply::NetworkError error = QNetworkReply::NoError; /**< Kod błędu. */
+        QString errorString;   /**< Opis błędu. */
+        QByteArray body;       /**< Treść odpowiedzi (pusta przy błędzie i przy parsowaniu strumieniowym). */
+        MeasurementSeries series; /**< Seria sparsowana strumieniowo (odpowiedzi data/getData). */
+        QString parseError;    /**< Błąd składni odpowiedzi parsowanej strumieniowo. */
+        bool delivered = false; /**< Czy wynik trafił też do odbiorcy innego niż prefetch. */
+        bool fromCache = false; /**< Czy odpowiedź pochodzi z cache HTTP. */
+    };
 
-private:
-    QString currentCity; /**< Przechowuje miasto dla bieżącego żądania. */
-    int currentStationId; /**< Przechowuje ID stacji dla bieżącego żądania. */
-    int currentSensorId; /**< Przechowuje ID sensora dla bieżącego żądania. */
+    /**
+     * @brief Metoda obsługująca wynik żądania.
+     */
+    using ReplyHandler = void (ApiWorker::*)(const ApiReply &reply, const RequestContext &context);
+
+    /**
+     * @brief Odbiorca wyniku żądania.
+     */
+    struct Waiter {
+        RequestContext context; /**< Kontekst odbiorcy. */
+        ReplyHandler handler;   /**< Metoda obsługująca wynik. */
+    };
+
+    /**
+     * @brief Żądanie w locie wraz ze wszystkimi odbiorcami, którzy na nie czekają.
+     */
+    struct InFlightRequest {
+        QNetworkRequest request;        /**< Żądanie (do ponowień). */
+        QNetworkReply *reply = nullptr; /**< Bieżąca odpowiedź; nullptr w trakcie odczekiwania przed ponowieniem. */
+        QVector<Waiter> waiters;        /**< Odbiorcy wyniku (pierwszy i dołączeni). */
+        quint64 serial = 0;             /**< Numer żądania (odróżnia je od późniejszego o ten sam adres). */
+        int attempt = 0;                /**< Liczba wykonanych prób. */
+        bool shortCircuited = false;    /**< Czy bieżąca próba idzie tylko do cache (obwód otwarty). */
+        RequestScheduler::EndpointClass endpointClass = RequestScheduler::DataClass; /**< Klasa limitu tempa. */
+        RequestScheduler::Priority priority = RequestScheduler::Interactive; /**< Najwyższy priorytet odbiorców. */
+        bool queued = false;            /**< Czy bieżąca próba czeka w RequestScheduler. */
+        QSharedPointer<SeriesStreamParser> stream; /**< Parser danych bieżącej próby (tylko data/getData). */
+    };
+
+    /**
+     * @brief Wysyła GET albo dołącza do identycznego żądania, które jest już w locie.
+     *
+     * Odbiorca o wyższym priorytecie przenosi czekające jeszcze żądanie do swojej kolejki.
+     * @param request Żądanie.
+     * @param context Kontekst odbiorcy.
+     * @param handler Metoda obsługująca wynik.
+     * @param endpointClass Klasa endpointu, której limit tempa obowiązuje żądanie.
+     */
+    void get(const QNetworkRequest &request, const RequestContext &context, ReplyHandler handler,
+             RequestScheduler::EndpointClass endpointClass);
+
+    /**
+     * @brief Zaczyna nową generację grupy: usuwa odbiorców ze starszych generacji,
+     *        a żądania bez odbiorców przerywa (QNetworkReply::abort).
+     * @param group Grupa żądań.
+     * @param context Kontekst nowego żądania - dostaje numer nowej generacji.
+     */
+    void supersede(SupersedeGroup group, RequestContext &context);
+
+    /**
+     * @brief Wysyła kolejną próbę żądania z inFlight; przy otwartym obwodzie tylko do cache.
+     *
+     * Żądanie do sieci czeka w RequestScheduler na żeton swojej klasy endpointu.
+     * @param url Adres żądania (klucz w inFlight).
+     */
+    void send(const QUrl &url);
+
+    /**
+     * @brief Kolejkuje bieżącą próbę żądania w RequestScheduler z priorytetem żądania.
+     * @param url Adres żądania (klucz w inFlight).
+     */
+    void schedule(const QUrl &url);
+
+    /**
+     * @brief Przekazuje bieżącą próbę żądania do QNetworkAccessManager.
+     * @param url Adres żądania (klucz w inFlight).
+     * @return Odpowiedź bieżącej próby.
+     */
+    QNetworkReply *dispatch(const QUrl &url);
+
+    /**
+     * @brief Odczytuje zakończoną odpowiedź i przekazuje wynik wszystkim odbiorcom.
+     *
+     * Błąd przejściowy jest najpierw ponawiany zgodnie z RetryPolicy.
+     * @param reply Zakończona odpowiedź.
+     * @param url Adres żądania (klucz w inFlight).
+     */
+    void onReplyFinished(QNetworkReply *reply, const QUrl &url);
+
+    /**
+     * @brief Obsługuje listę stacji.
+     */
+    void onStationsFetched(const ApiReply &reply, const RequestContext &context);
+
+    /**
+     * @brief Obsługuje listę sensorów stacji.
+     */
+    void onSensorsFetched(const ApiReply &reply, const RequestContext &context);
+
+    /**
+     * @brief Obsługuje dane pomiarowe sensora.
+     */
+    void onDataFetched(const ApiReply &reply, const RequestContext &context);
+
+    /**
+     * @brief Obsługuje listę sensorów pobraną w ramach migawki stacji.
+     */
+    void onSnapshotSensorsFetched(const ApiReply &reply, const RequestContext &context);
+
+    /**
+     * @brief Obsługuje dane jednego sensora pobrane w ramach migawki stacji.
+     */
+    void onSnapshotDataFetched(const ApiReply &reply, const RequestContext &context);
+
+    /**
+     * @brief Zapamiętuje listę sensorów z prefetchu i pobiera w tle dane sensorów.
+     */
+    void onPrefetchSensorsFetched(const ApiReply &reply, const RequestContext &context);
+
+    /**
+     * @brief Zapamiętuje dane sensora z prefetchu.
+     */
+    void onPrefetchDataFetched(const ApiReply &reply, const RequestContext &context);
+
+    /**
+     * @brief Czy metoda obsługuje wynik prefetchu (a nie żądanie użytkownika lub migawki).
+     * @param handler Metoda obsługująca wynik.
+     */
+    static bool isPrefetchHandler(ReplyHandler handler);
+
+    /**
+     * @brief Czy pod adresem czeka aktualny wynik prefetchu.
+     * @param url Adres żądania.
+     */
+    bool hasPrefetched(const QUrl &url) const;
+
+    /**
+     * @brief Treść odpowiedzi pobranej przez prefetch.
+     */
+    struct PrefetchedReply {
+        ApiReply reply;         /**< Wynik żądania. */
+        qint64 fetchedAtMs = 0; /**< Czas pobrania w ms od epoki. */
+    };
+
+    /**
+     * @brief Stan migawki stacji zbieranej z wielu równoległych odpowiedzi.
+     */
+    struct StationSnapshot {
+        int stationId = 0;      /**< Identyfikator stacji. */
+        QJsonArray sensors;     /**< Lista sensorów stacji. */
+        QVector<SeriesSlice> slices; /**< Serie sensorów przycięte do zakresu dat. */
+        qint64 fromMs = 0;      /**< Początek zakresu dat. */
+        qint64 toMs = 0;        /**< Koniec zakresu dat. */
+        int pending = 0;        /**< Liczba żądań o dane, które jeszcze trwają. */
+    };
+
+    /**
+     * @brief Sprawdza błąd odpowiedzi i parsuje jej treść jako JSON.
+     * @param reply Wynik zakończonego żądania.
+     * @param doc Dokument wynikowy.
+     * @return true, jeśli odpowiedź jest poprawna; w przeciwnym razie emituje networkError().
+     */
+    bool parseReply(const ApiReply &reply, QJsonDocument &doc);
+
+    /**
+     * @brief Zapisuje dokument JSON do pliku w katalogu offline.
+     * @param filename Ścieżka pliku.
+     * @param doc Dokument do zapisania.
+     */
+    void writeOfflineFile(const QString &filename, const QJsonDocument &doc);
+
+    /**
+     * @brief Dołącza serię pomiarową do archiwum w binarnym pliku offline (SeriesFile::merge).
+     * @param series Seria do zapisania.
+     */
+    void writeOfflineSeries(const MeasurementSeries &series);
+
+    ApiEndpoints endpoints; /**< Adres bazowy i ścieżki endpointów API. */
+    StationCatalog stationCatalog; /**< Katalog stacji z ostatniej listy station/findAll. */
+    QHash<QUrl, InFlightRequest> inFlight; /**< Żądania w locie według adresu. */
+    int coalescedCount = 0; /**< Liczba żądań obsłużonych przez dołączenie do trwającego. */
+    quint64 generations[GroupCount] = {}; /**< Bieżąca generacja każdej grupy. */
+    quint64 lastRequestSerial = 0; /**< Ostatnio nadany numer żądania. */
+    RetryPolicy retryPolicy; /**< Polityka ponawiania. */
+    CircuitBreaker circuitBreaker; /**< Wyłącznik obwodu dla każdego hosta. */
+    QRandomGenerator random; /**< Losowy rozrzut opóźnień ponowień. */
+    int retriedCount = 0; /**< Liczba ponowionych prób. */
+    int abortedCount = 0; /**< Liczba przerwanych, zastąpionych żądań. */
+    QHash<int, StationSnapshot> snapshots; /**< Migawki stacji w trakcie pobierania. */
+    int lastSnapshotId = 0; /**< Ostatnio nadany identyfikator migawki. */
+    QHash<QUrl, PrefetchedReply> prefetched; /**< Wyniki prefetchu czekające na żądanie interaktywne. */
+    qint64 prefetchMaxAgeMs = 10 * 60 * 1000; /**< Czas ważności wyniku prefetchu. */
+    int prefetchHits = 0; /**< Liczba żądań obsłużonych z prefetchu. */
 };
 
 #endif // APIWORKER_H
@@ -0,0 +1,115 @@
+#include "batcharchiver.h"
+#include <limits>
+
+BatchArchiver::BatchArchiver(ApiWorker *worker, QObject *parent)
+    : QObject(parent), worker(worker)
+{
+    connect(worker, &ApiWorker::stationCatalogReady, this, &BatchArchiver::onCatalogReady);
+    connect(worker, &ApiWorker::stationsFetchFailed, this, &BatchArchiver::onStationsFetchFailed);
+    connect(worker, &ApiWorker::stationSnapshotFetched, this, &BatchArchiver::onSnapshotFetched);
+    connect(worker, &ApiWorker::stationSnapshotFailed, this, &BatchArchiver::onSnapshotFailed);
+    connect(worker, &ApiWorker::networkError, this, &BatchArchiver::onNetworkError);
+}
+
+void BatchArchiver::setMaxConcurrent(int count) {
+    maxConcurrent = qMax(1, count);
+}
+
+void BatchArchiver::start(const QStringList &cities, const QVector<int> &stationIds) {
+    this->cities = cities;
+    for (int id : stationIds) {
+        if (!queued.contains(id)) {
+            queued.insert(id);
+            queue.enqueue(id);
+        }
+    }
+
+    if (!cities.isEmpty()) {
+        // Lista stacji jest jedna dla całego kraju - wystarczy jedno żądanie dla wszystkich miast
+        waitingForStations = true;
+        worker->fetchStations(cities.first());
+    }
+    startNext();
+    finishIfIdle();
+}
+
+void BatchArchiver::onCatalogReady(const StationCatalog &catalog, const QString &city) {
+    Q_UNUSED(city);
+    if (!waitingForStations) return;
+    waitingForStations = false;
+
+    for (const QString &name : std::as_const(cities)) {
+        const QVector<int> ids = catalog.stationIdsInCity(name);
+        if (ids.isEmpty()) {
+            emit message("No stations found for city: " + name);
+            unresolvedCity = true;
+        }
+        for (int id : ids) {
+            if (!queued.contains(id)) {
+                queued.insert(id);
+                queue.enqueue(id);
+            }
+        }
+    }
+
+    startNext();
+    finishIfIdle();
+}
+
+void BatchArchiver::onSnapshotFetched(const QJsonArray &sensors, int stationId, const QVector<SeriesSlice> &slices) {
+    if (!inFlight.remove(stationId)) return;
+
+    // Sensor bez danych w wyniku oznacza błąd jego żądania
+    int expected = 0;
+    for (const QJsonValue &val : sensors) {
+        if (val.toObject()["id"].toInt() > 0) ++expected;
+    }
+    if (slices.size() < expected) {
+        emit message(QString("Station %1: %2 of %3 sensors saved").arg(stationId).arg(slices.size()).arg(expected));
+        ++failedCount;
+    } else {
+        emit message(QString("Station %1: %2 sensors saved").arg(stationId).arg(slices.size()));
+        ++doneCount;
+    }
+
+    startNext();
+    finishIfIdle();
+}
+
+void BatchArchiver::onSnapshotFailed(int stationId) {
+    if (!inFlight.remove(stationId)) return;
+    emit message(QString("Station %1: failed").arg(stationId));
+    ++failedCount;
+
+    startNext();
+    finishIfIdle();
+}
+
+void BatchArchiver::onStationsFetchFailed(const QString &city) {
+    Q_UNUSED(city);
+    if (!waitingForStations || done) return;
+    // Błędy pojedynczych stacji (np. z --station) nie przerywają zadania - tylko brak listy stacji
+    waitingForStations = false;
+    done = true;
+    emit finished(StationListFailed);
+}
+
+void BatchArchiver::onNetworkError(const QString &errorString) {
+    emit message("Error: " + errorString);
+}
+
+void BatchArchiver::startNext() {
+    while (!done && inFlight.size() < maxConcurrent && !queue.isEmpty()) {
+        const int stationId = queue.dequeue();
+        inFlight.insert(stationId);
+        // Synchronizacja archiwum to praca w tle - nie blokuje żądań interaktywnych
+        worker->fetchStationSnapshot(stationId, std::numeric_limits<qint64>::min(),
+                                     std::numeric_limits<qint64>::max(), RequestScheduler::Background);
+    }
+}
+
+void BatchArchiver::finishIfIdle() {
+    if (done || waitingForStations || !inFlight.isEmpty() || !queue.isEmpty()) return;
+    done = true;
+    emit finished(failedCount > 0 || unresolvedCity ? PartialFailure : Success);
+}
@@ -0,0 +1,119 @@
+#ifndef BATCHARCHIVER_H
+#define BATCHARCHIVER_H
+
+#include <QObject>
+#include <QQueue>
+#include <QSet>
+#include <QStringList>
+#include "apiworker.h"
+
+/**
+ * @class BatchArchiver
+ * @brief Wsadowe pobieranie stacji, sensorów i danych do magazynu offline, bez GUI.
+ *
+ * Dla podanych miast pobiera listę stacji (raz - katalog obejmuje cały kraj), a następnie
+ * migawki wszystkich stacji z miast i z listy ID, najwyżej maxConcurrent naraz.
+ * Zapis plików offline wykonuje ApiWorker. Po zakończeniu emituje finished() z kodem
+ * wyjścia dla crona. Żądania idą z priorytetem RequestScheduler::Background.
+ */
+class BatchArchiver : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Kody wyjścia zadania wsadowego.
+     */
+    enum ExitCode {
+        Success = 0,              /**< Wszystkie stacje i sensory zapisane. */
+        UsageError = 1,           /**< Błędne argumenty (zgłaszane przez program CLI). */
+        StationListFailed = 2,    /**< Nie udało się pobrać listy stacji. */
+        PartialFailure = 3        /**< Część miast, stacji lub sensorów się nie pobrała. */
+    };
+
+    /**
+     * @brief Tworzy zadanie korzystające z podanego ApiWorker (w tym samym wątku).
+     * @param worker ApiWorker wykonujący żądania i zapis plików offline.
+     * @param parent Rodzic obiektu.
+     */
+    explicit BatchArchiver(ApiWorker *worker, QObject *parent = nullptr);
+
+    /**
+     * @brief Ustawia maksymalną liczbę stacji pobieranych równolegle.
+     * @param count Liczba stacji (co najmniej 1).
+     */
+    void setMaxConcurrent(int count);
+
+    /**
+     * @brief Rozpoczyna zadanie.
+     * @param cities Miasta, których wszystkie stacje mają zostać pobrane.
+     * @param stationIds Dodatkowe identyfikatory stacji.
+     */
+    void start(const QStringList &cities, const QVector<int> &stationIds);
+
+    int stationsDone() const { return doneCount; }     /**< Liczba stacji zapisanych w całości. */
+    int stationsFailed() const { return failedCount; } /**< Liczba stacji z błędem (także częściowym). */
+
+signals:
+    /**
+     * @brief Sygnał emitowany po zakończeniu zadania.
+     * @param exitCode Kod wyjścia (ExitCode).
+     */
+    void finished(int exitCode);
+
+    /**
+     * @brief Komunikat o postępie lub błędzie do wypisania przez program.
+     * @param message Treść komunikatu.
+     */
+    void message(const QString &message);
+
+private slots:
+    /**
+     * @brief Zamienia miasta na identyfikatory stacji i kolejkuje je.
+     */
+    void onCatalogReady(const StationCatalog &catalog, const QString &city);
+
+    /**
+     * @brief Zlicza zapisaną stację i wysyła kolejną z kolejki.
+     */
+    void onSnapshotFetched(const QJsonArray &sensors, int stationId, const QVector<SeriesSlice> &slices);
+
+    /**
+     * @brief Zlicza stację z błędem i wysyła kolejną z kolejki.
+     */
+    void onSnapshotFailed(int stationId);
+
+    /**
+     * @brief Kończy zadanie kodem StationListFailed, jeśli nie pobrała się lista stacji.
+     */
+    void onStationsFetchFailed(const QString &city);
+
+    /**
+     * @brief Przekazuje błąd jako komunikat.
+     */
+    void onNetworkError(const QString &errorString);
+
+private:
+    /**
+     * @brief Wysyła kolejne migawki z kolejki, aż do limitu równoległości.
+     */
+    void startNext();
+
+    /**
+     * @brief Kończy zadanie, gdy kolejka i żądania w locie są puste.
+     */
+    void finishIfIdle();
+
+    ApiWorker *worker;          /**< Wykonawca żądań. */
+    QStringList cities;         /**< Miasta do rozwiązania na ID stacji. */
+    QQueue<int> queue;          /**< Stacje czekające na pobranie. */
+    QSet<int> queued;           /**< Stacje już zakolejkowane (bez duplikatów). */
+    QSet<int> inFlight;         /**< Stacje pobierane w tej chwili. */
+    int maxConcurrent = 4;      /**< Limit równoległych migawek. */
+    bool waitingForStations = false; /**< Czy trwa pobieranie listy stacji. */
+    bool unresolvedCity = false;     /**< Czy któreś miasto nie ma stacji w katalogu. */
+    bool done = false;          /**< Czy finished() został już wyemitowany. */
+    int doneCount = 0;          /**< Stacje zapisane w całości. */
+    int failedCount = 0;        /**< Stacje z błędem. */
+};
+
+#endif // BATCHARCHIVER_H
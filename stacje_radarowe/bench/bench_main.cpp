@@ -0,0 +1,247 @@
+#include <benchmark/benchmark.h>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtCharts/QLineSeries>
+#include <cmath>
+#include "stationcatalog.h"
+#include "measurementseries.h"
+#include "seriesstreamparser.h"
+#include "timestampparser.h"
+#include "downsampler.h"
+
+// Mikrobenchmarki ścieżek parsowania, filtrowania, statystyk i budowy serii wykresu.
+// Dane: próbki offline/*.json z repozytorium (BENCH_SAMPLE_DIR) oraz dane syntetyczne
+// w skali podanej argumentem benchmarku.
+
+static QByteArray readSample(const QString &name) {
+    QFile file(QStringLiteral(BENCH_SAMPLE_DIR) + "/" + name);
+    if (!file.open(QIODevice::ReadOnly))
+        qFatal("Brak pliku próbki: %s", qPrintable(file.fileName()));
+    return file.readAll();
+}
+
+// Lista stacji powielona `copies` razy z unikalnymi ID - skala "tysiące stacji"
+static QJsonArray scaledStations(int copies) {
+    const QJsonArray sample = QJsonDocument::fromJson(readSample("stacje.json")).array();
+    QJsonArray stations;
+    for (int copy = 0; copy < copies; ++copy) {
+        for (const QJsonValue &val : sample) {
+            QJsonObject station = val.toObject();
+            station["id"] = station["id"].toInt() + copy * 100000;
+            stations.append(station);
+        }
+    }
+    return stations;
+}
+
+// Odpowiedź getData z `hours` godzinnymi pomiarami (malejąco jak w API) i co 50. brakiem danych
+static QJsonObject syntheticData(int hours) {
+    QJsonArray values;
+    QDateTime time(QDate(2025, 1, 1), QTime(0, 0));
+    for (int i = 0; i < hours; ++i) {
+        QJsonObject ob;
+        ob["date"] = time.addSecs(-3600LL * i).toString("yyyy-MM-dd HH:mm:ss");
+        ob["value"] = (i % 50 == 0) ? QJsonValue(QJsonValue::Null) : QJsonValue(20.0 + 10.0 * std::sin(i / 24.0));
+        values.append(ob);
+    }
+    QJsonObject data;
+    data["key"] = "PM10";
+    data["values"] = values;
+    return data;
+}
+
+static void BM_ParseStationsJson(benchmark::State &state) {
+    const QByteArray json = QJsonDocument(scaledStations(int(state.range(0)))).toJson();
+    for (auto _ : state) {
+        QJsonDocument doc = QJsonDocument::fromJson(json);
+        benchmark::DoNotOptimize(doc);
+    }
+    state.SetBytesProcessed(state.iterations() * json.size());
+}
+BENCHMARK(BM_ParseStationsJson)->Arg(1)->Arg(20);
+
+static void BM_BuildStationCatalog(benchmark::State &state) {
+    const QJsonArray stations = scaledStations(int(state.range(0)));
+    for (auto _ : state) {
+        StationCatalog catalog = StationCatalog::fromJson(stations);
+        benchmark::DoNotOptimize(catalog);
+    }
+    state.SetItemsProcessed(state.iterations() * stations.size());
+}
+BENCHMARK(BM_BuildStationCatalog)->Arg(1)->Arg(20);
+
+// Dawna logika handleStationsFetched: przejście po całej tablicy JSON przy każdym zapytaniu
+static void BM_FilterCityLinear(benchmark::State &state) {
+    const QJsonArray stations = scaledStations(int(state.range(0)));
+    const QString city = "Kraków";
+    for (auto _ : state) {
+        int found = 0;
+        for (const QJsonValue &val : stations) {
+            QJsonObject station = val.toObject();
+            if (station["city"].toObject()["name"].toString() == city)
+                ++found;
+        }
+        benchmark::DoNotOptimize(found);
+    }
+}
+BENCHMARK(BM_FilterCityLinear)->Arg(1)->Arg(20);
+
+static void BM_FilterCityCatalog(benchmark::State &state) {
+    const StationCatalog catalog = StationCatalog::fromJson(scaledStations(int(state.range(0))));
+    const QString city = "Kraków";
+    for (auto _ : state) {
+        QVector<int> ids = catalog.stationIdsInCity(city);
+        benchmark::DoNotOptimize(ids);
+    }
+}
+BENCHMARK(BM_FilterCityCatalog)->Arg(1)->Arg(20);
+
+static void BM_NearestStations(benchmark::State &state) {
+    const StationCatalog catalog = StationCatalog::fromJson(scaledStations(int(state.range(0))));
+    for (auto _ : state) {
+        QVector<GeoMatch> matches = catalog.nearestStations(50.06, 19.94, 5);
+        benchmark::DoNotOptimize(matches);
+    }
+}
+BENCHMARK(BM_NearestStations)->Arg(1)->Arg(20);
+
+static void BM_ParseDateQDateTime(benchmark::State &state) {
+    const QString date = "2025-04-27 19:00:00";
+    for (auto _ : state) {
+        QDateTime dateTime = QDateTime::fromString(date, "yyyy-MM-dd HH:mm:ss");
+        benchmark::DoNotOptimize(dateTime);
+    }
+}
+BENCHMARK(BM_ParseDateQDateTime);
+
+static void BM_ParseDateTimestampParser(benchmark::State &state) {
+    const QString date = "2025-04-27 19:00:00";
+    TimestampParser parser;
+    for (auto _ : state) {
+        qint64 timestamp = 0;
+        parser.parse(date, timestamp);
+        benchmark::DoNotOptimize(timestamp);
+    }
+}
+BENCHMARK(BM_ParseDateTimestampParser);
+
+static void BM_SeriesFromSampleJson(benchmark::State &state) {
+    const QJsonObject data = QJsonDocument::fromJson(readSample("dane_6085.json")).object();
+    for (auto _ : state) {
+        MeasurementSeries series = MeasurementSeries::fromJson(data, 6085);
+        benchmark::DoNotOptimize(series);
+    }
+}
+BENCHMARK(BM_SeriesFromSampleJson);
+
+static void BM_SeriesFromJson(benchmark::State &state) {
+    const QJsonObject data = syntheticData(int(state.range(0)));
+    for (auto _ : state) {
+        MeasurementSeries series = MeasurementSeries::fromJson(data, 6085);
+        benchmark::DoNotOptimize(series);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SeriesFromJson)->Arg(24 * 7)->Arg(24 * 365)->Arg(24 * 365 * 10);
+
+// Surowa odpowiedź -> seria: DOM QJsonDocument vs parser strumieniowy w porcjach po 16 KB
+static void BM_SeriesFromBytesDom(benchmark::State &state) {
+    const QByteArray body = QJsonDocument(syntheticData(int(state.range(0)))).toJson(QJsonDocument::Compact);
+    for (auto _ : state) {
+        MeasurementSeries series = MeasurementSeries::fromJson(QJsonDocument::fromJson(body).object(), 6085);
+        benchmark::DoNotOptimize(series);
+    }
+    state.SetBytesProcessed(state.iterations() * body.size());
+}
+BENCHMARK(BM_SeriesFromBytesDom)->Arg(24 * 365)->Arg(24 * 365 * 10);
+
+static void BM_SeriesStreamParser(benchmark::State &state) {
+    const QByteArray body = QJsonDocument(syntheticData(int(state.range(0)))).toJson(QJsonDocument::Compact);
+    const qsizetype chunk = 16 * 1024;
+    for (auto _ : state) {
+        SeriesStreamParser parser;
+        for (qsizetype offset = 0; offset < body.size(); offset += chunk)
+            parser.feed(body.mid(offset, chunk));
+        parser.finish();
+        MeasurementSeries series = parser.takeSeries(6085);
+        benchmark::DoNotOptimize(series);
+    }
+    state.SetBytesProcessed(state.iterations() * body.size());
+}
+BENCHMARK(BM_SeriesStreamParser)->Arg(24 * 365)->Arg(24 * 365 * 10);
+
+// Dawna pętla statystyk: po obiektach JSON, z QJsonValue::isNull i toDouble dla każdego punktu
+static void BM_StatsJsonLoop(benchmark::State &state) {
+    const QJsonArray values = syntheticData(int(state.range(0)))["values"].toArray();
+    for (auto _ : state) {
+        double sum = 0.0, minValue = 0.0, maxValue = 0.0;
+        int count = 0;
+        for (const QJsonValue &val : values) {
+            QJsonObject ob = val.toObject();
+            if (ob["value"].isNull()) continue;
+            const double value = ob["value"].toDouble();
+            if (count == 0 || value < minValue) minValue = value;
+            if (count == 0 || value > maxValue) maxValue = value;
+            sum += value;
+            ++count;
+        }
+        benchmark::DoNotOptimize(sum);
+        benchmark::DoNotOptimize(minValue);
+        benchmark::DoNotOptimize(maxValue);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StatsJsonLoop)->Arg(24 * 365)->Arg(24 * 365 * 10);
+
+static void BM_StatsColumns(benchmark::State &state) {
+    const MeasurementSeries series = MeasurementSeries::fromJson(syntheticData(int(state.range(0))), 6085);
+    for (auto _ : state) {
+        SeriesStats stats = SeriesStats::compute(series);
+        benchmark::DoNotOptimize(stats);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StatsColumns)->Arg(24 * 365)->Arg(24 * 365 * 10);
+
+static void BM_SliceRange(benchmark::State &state) {
+    const MeasurementSeries series = MeasurementSeries::fromJson(syntheticData(int(state.range(0))), 6085);
+    const qint64 toMs = series.timestamps.last();
+    const qint64 fromMs = toMs - 7LL * 24 * 3600 * 1000;
+    for (auto _ : state) {
+        SeriesSlice slice = SeriesSlice::make(series, fromMs, toMs);
+        benchmark::DoNotOptimize(slice);
+    }
+}
+BENCHMARK(BM_SliceRange)->Arg(24 * 365)->Arg(24 * 365 * 10);
+
+// Budowa serii wykresu: punkty -> (opcjonalnie LTTB do 1000 px) -> QLineSeries::replace
+static void BM_ChartSeries(benchmark::State &state) {
+    const MeasurementSeries series = MeasurementSeries::fromJson(syntheticData(int(state.range(0))), 6085);
+    const bool decimate = state.range(1) != 0;
+    QLineSeries lineSeries;
+    for (auto _ : state) {
+        QList<QPointF> points;
+        points.reserve(series.size());
+        for (int i = 0; i < series.size(); ++i) {
+            if (!series.isNull(i))
+                points.append(QPointF(series.timestamps[i], series.values[i]));
+        }
+        lineSeries.replace(decimate ? Downsampler::lttb(points, 1000) : points);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ChartSeries)->Args({24 * 365, 0})->Args({24 * 365, 1})->Args({24 * 365 * 10, 0})->Args({24 * 365 * 10, 1});
+
+int main(int argc, char **argv) {
+    QCoreApplication app(argc, argv);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
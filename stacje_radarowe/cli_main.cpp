@@ -0,0 +1,96 @@
+#include "apiworker.h"
+#include "batcharchiver.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QTimer>
+#include <QTextStream>
+
+// Tryb wsadowy bez GUI: pobiera stacje, sensory i dane do katalogu offline/,
+// np. z crona, żeby wypełnić magazyn offline dla wielu kiosków jednym zadaniem.
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("stacje_radarowe_cli");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Pobiera dane GIOŚ do magazynu offline (offline/).");
+    parser.addHelpOption();
+    QCommandLineOption cityOption({"c", "city"}, "Miasto, którego stacje pobrać (można powtarzać).", "miasto");
+    QCommandLineOption stationOption({"s", "station"}, "ID stacji do pobrania (można powtarzać).", "id");
+    QCommandLineOption jobsOption({"j", "jobs"}, "Liczba stacji pobieranych równolegle.", "n", "4");
+    QCommandLineOption outputOption({"o", "output"}, "Katalog roboczy, w którym powstaje offline/.", "katalog");
+    QCommandLineOption rateOption({"r", "rate"}, "Limit żądań sensorów i danych na sekundę.", "n", "5");
+    parser.addOptions({cityOption, stationOption, jobsOption, outputOption, rateOption});
+    ApiEndpoints::addCommandLineOptions(parser);
+    parser.process(app);
+
+    QTextStream err(stderr);
+
+    QVector<int> stationIds;
+    for (const QString &value : parser.values(stationOption)) {
+        bool ok = false;
+        const int id = value.toInt(&ok);
+        if (!ok || id <= 0) {
+            err << "Invalid station ID: " << value << Qt::endl;
+            return BatchArchiver::UsageError;
+        }
+        stationIds.append(id);
+    }
+
+    bool jobsOk = false;
+    const int jobs = parser.value(jobsOption).toInt(&jobsOk);
+    if (!jobsOk || jobs <= 0) {
+        err << "Invalid number of jobs: " << parser.value(jobsOption) << Qt::endl;
+        return BatchArchiver::UsageError;
+    }
+
+    bool rateOk = false;
+    const double rate = parser.value(rateOption).toDouble(&rateOk);
+    if (!rateOk || rate <= 0) {
+        err << "Invalid request rate: " << parser.value(rateOption) << Qt::endl;
+        return BatchArchiver::UsageError;
+    }
+
+    const QStringList cities = parser.values(cityOption);
+    if (cities.isEmpty() && stationIds.isEmpty()) {
+        err << "Nothing to fetch: give at least one --city or --station" << Qt::endl;
+        return BatchArchiver::UsageError;
+    }
+
+    // Konfigurację czytamy przed zmianą katalogu roboczego (względna ścieżka --config)
+    const ApiEndpoints endpoints = ApiEndpoints::fromConfiguration(&parser);
+
+    if (parser.isSet(outputOption)) {
+        const QString dir = parser.value(outputOption);
+        if (!QDir().mkpath(dir) || !QDir::setCurrent(dir)) {
+            err << "Cannot use output directory: " << dir << Qt::endl;
+            return BatchArchiver::UsageError;
+        }
+    }
+
+    ApiWorker worker;
+    worker.setEndpoints(endpoints);
+    // Burst na dwie sekundy limitu - start zadania nie czeka na pierwsze żetony
+    const int burst = qMax(1, int(rate * 2));
+    worker.setRateLimit(RequestScheduler::SensorsClass, rate, burst);
+    worker.setRateLimit(RequestScheduler::DataClass, rate, burst);
+    // Bez GUI nie ma żądań interaktywnych - praca w tle może zająć wszystkie połączenia do hosta
+    worker.setMaxConcurrent(RequestScheduler::Background, 6);
+    BatchArchiver archiver(&worker);
+    archiver.setMaxConcurrent(jobs);
+
+    QObject::connect(&archiver, &BatchArchiver::message, [&err](const QString &message) {
+        err << message << Qt::endl;
+    });
+    QObject::connect(&archiver, &BatchArchiver::finished, &app, [&](int exitCode) {
+        err << "Done: " << archiver.stationsDone() << " stations saved, "
+            << archiver.stationsFailed() << " failed" << Qt::endl;
+        QCoreApplication::exit(exitCode);
+    });
+
+    // Start po wejściu do pętli zdarzeń, żeby exit() z finished() zadziałał także od razu
+    QTimer::singleShot(0, &archiver, [&]() { archiver.start(cities, stationIds); });
+    return app.exec();
+}
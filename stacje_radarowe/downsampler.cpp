@@ -0,0 +1,66 @@
+#include "downsampler.h"
+#include <algorithm>
+#include <cmath>
+
+QList<QPointF> Downsampler::lttb(const QList<QPointF> &points, int threshold) {
+    const int n = points.size();
+    if (threshold < 3 || n <= threshold)
+        return points;
+
+    QList<QPointF> sampled;
+    sampled.reserve(threshold);
+    sampled.append(points.first());
+
+    // Punkty wewnętrzne dzielimy na threshold - 2 kubełki; z każdego bierzemy punkt
+    // tworzący największy trójkąt z poprzednio wybranym i średnią następnego kubełka.
+    const double bucketSize = double(n - 2) / (threshold - 2);
+    int previous = 0;
+
+    for (int bucket = 0; bucket < threshold - 2; ++bucket) {
+        const int rangeStart = int(std::floor(bucket * bucketSize)) + 1;
+        const int rangeEnd = std::min(int(std::floor((bucket + 1) * bucketSize)) + 1, n - 1);
+
+        int avgStart = rangeEnd;
+        int avgEnd = std::min(int(std::floor((bucket + 2) * bucketSize)) + 1, n);
+        if (avgEnd <= avgStart)
+            avgEnd = std::min(avgStart + 1, n);
+
+        double avgX = 0.0;
+        double avgY = 0.0;
+        for (int i = avgStart; i < avgEnd; ++i) {
+            avgX += points[i].x();
+            avgY += points[i].y();
+        }
+        avgX /= (avgEnd - avgStart);
+        avgY /= (avgEnd - avgStart);
+
+        const QPointF &a = points[previous];
+        double maxArea = -1.0;
+        int selected = rangeStart;
+        for (int i = rangeStart; i < rangeEnd; ++i) {
+            const double area = std::abs((a.x() - avgX) * (points[i].y() - a.y())
+                                         - (a.x() - points[i].x()) * (avgY - a.y()));
+            if (area > maxArea) {
+                maxArea = area;
+                selected = i;
+            }
+        }
+
+        sampled.append(points[selected]);
+        previous = selected;
+    }
+
+    sampled.append(points.last());
+    return sampled;
+}
+
+QList<QPointF> Downsampler::visible(const QList<QPointF> &points, double minX, double maxX) {
+    auto byX = [](const QPointF &p, double x) { return p.x() < x; };
+    auto first = std::lower_bound(points.cbegin(), points.cend(), minX, byX);
+    auto last = std::upper_bound(points.cbegin(), points.cend(), maxX,
+                                 [](double x, const QPointF &p) { return x < p.x(); });
+
+    if (first != points.cbegin()) --first;
+    if (last != points.cend()) ++last;
+    return QList<QPointF>(first, last);
+}
@@ -0,0 +1,36 @@
+#ifndef DOWNSAMPLER_H
+#define DOWNSAMPLER_H
+
+#include <QList>
+#include <QPointF>
+
+/**
+ * @class Downsampler
+ * @brief Decymacja punktów wykresu do rozdzielczości widoku.
+ *
+ * Wykres nie pokaże więcej punktów niż ma pikseli w poziomie, więc przed przekazaniem
+ * do QLineSeries seria jest zmniejszana algorytmem Largest-Triangle-Three-Buckets (LTTB).
+ * LTTB zachowuje kształt przebiegu, w tym pojedyncze skoki wartości. Pełne dane
+ * pozostają u wywołującego (statystyki, ponowna decymacja po przybliżeniu).
+ */
+class Downsampler {
+public:
+    /**
+     * @brief Zmniejsza serię do co najwyżej threshold punktów (LTTB).
+     * @param points Punkty posortowane rosnąco po x.
+     * @param threshold Docelowa liczba punktów; poniżej 3 seria nie jest zmieniana.
+     * @return Punkty wybrane z serii (zawsze z pierwszym i ostatnim).
+     */
+    static QList<QPointF> lttb(const QList<QPointF> &points, int threshold);
+
+    /**
+     * @brief Zwraca punkty z zakresu [minX, maxX] oraz po jednym sąsiedzie z każdej strony,
+     *        żeby linia dochodziła do krawędzi widoku.
+     * @param points Punkty posortowane rosnąco po x.
+     * @param minX Początek widocznego zakresu.
+     * @param maxX Koniec widocznego zakresu.
+     */
+    static QList<QPointF> visible(const QList<QPointF> &points, double minX, double maxX);
+};
+
+#endif // DOWNSAMPLER_H
@@ -0,0 +1,39 @@
+#include "httpcache.h"
+#include <QDateTime>
+
+HttpCache::HttpCache(const QString &directory, QObject *parent) : QNetworkDiskCache(parent) {
+    setCacheDirectory(directory);
+}
+
+void HttpCache::setMaxAge(qint64 seconds) {
+    maxAgeSeconds = seconds;
+}
+
+qint64 HttpCache::maxAge() const {
+    return maxAgeSeconds;
+}
+
+QIODevice *HttpCache::prepare(const QNetworkCacheMetaData &metaData) {
+    return QNetworkDiskCache::prepare(withMaxAge(metaData));
+}
+
+void HttpCache::updateMetaData(const QNetworkCacheMetaData &metaData) {
+    QNetworkDiskCache::updateMetaData(withMaxAge(metaData));
+}
+
+QNetworkCacheMetaData HttpCache::withMaxAge(const QNetworkCacheMetaData &metaData) const {
+    QNetworkCacheMetaData result = metaData;
+
+    // Nagłówki serwera zabraniające przechowywania zastępujemy własną polityką;
+    // ETag i Last-Modified zostają, bo na nich opiera się rewalidacja.
+    QNetworkCacheMetaData::RawHeaderList headers;
+    for (const QNetworkCacheMetaData::RawHeader &header : metaData.rawHeaders()) {
+        const QByteArray name = header.first.toLower();
+        if (name == "cache-control" || name == "pragma" || name == "expires") continue;
+        headers.append(header);
+    }
+    result.setRawHeaders(headers);
+    result.setSaveToDisk(true);
+    result.setExpirationDate(QDateTime::currentDateTimeUtc().addSecs(maxAgeSeconds));
+    return result;
+}
@@ -0,0 +1,52 @@
+#ifndef HTTPCACHE_H
+#define HTTPCACHE_H
+
+#include <QNetworkDiskCache>
+#include <QNetworkCacheMetaData>
+
+/**
+ * @class HttpCache
+ * @brief Dyskowy cache HTTP z konfigurowalnym czasem ważności wpisów.
+ *
+ * API GIOŚ nie zwraca użytecznych nagłówków Cache-Control, więc HttpCache nadpisuje
+ * datę wygaśnięcia każdego zapisywanego wpisu wartością "teraz + maxAge". Do tego czasu
+ * odpowiedź jest serwowana lokalnie; po nim QNetworkAccessManager wysyła żądanie
+ * warunkowe (If-None-Match / If-Modified-Since), a odpowiedź 304 odświeża tylko metadane.
+ */
+class HttpCache : public QNetworkDiskCache {
+    Q_OBJECT
+public:
+    /**
+     * @brief Konstruktor klasy HttpCache.
+     * @param directory Katalog, w którym przechowywane są wpisy cache.
+     * @param parent Wskaźnik na rodzica (domyślnie nullptr).
+     */
+    explicit HttpCache(const QString &directory, QObject *parent = nullptr);
+
+    /**
+     * @brief Ustawia czas ważności nowych i odświeżonych wpisów.
+     * @param seconds Czas w sekundach.
+     */
+    void setMaxAge(qint64 seconds);
+
+    /**
+     * @brief Zwraca czas ważności wpisów.
+     * @return Czas w sekundach.
+     */
+    qint64 maxAge() const;
+
+    QIODevice *prepare(const QNetworkCacheMetaData &metaData) override;
+    void updateMetaData(const QNetworkCacheMetaData &metaData) override;
+
+private:
+    /**
+     * @brief Ustawia datę wygaśnięcia i usuwa nagłówki blokujące cache.
+     * @param metaData Metadane otrzymane od serwera.
+     * @return Metadane do zapisania w cache.
+     */
+    QNetworkCacheMetaData withMaxAge(const QNetworkCacheMetaData &metaData) const;
+
+    qint64 maxAgeSeconds = 24 * 60 * 60; /**< Czas ważności wpisów w sekundach. */
+};
+
+#endif // HTTPCACHE_H
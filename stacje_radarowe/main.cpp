@@ -1,11 +1,33 @@
 #include "mainwindow.h"
 
 #include <QApplication>
+#include <QCommandLineParser>
 
 int main(int argc, char *argv[])
 {
+    // Bez GPU użyj programowej implementacji OpenGL (opengl32sw / Mesa), o ile Qt ją dostarcza
+    if (qEnvironmentVariableIsSet("STACJE_SOFTWARE_GL"))
+        QCoreApplication::setAttribute(Qt::AA_UseSoftwareOpenGL);
+
     QApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption openGlOption("opengl", "Zawsze rysuj wykres przez OpenGL.");
+    QCommandLineOption softwareOption("software", "Zawsze rysuj wykres programowo.");
+    parser.addOptions({openGlOption, softwareOption});
+    ApiEndpoints::addCommandLineOptions(parser);
+    parser.process(a);
+
     MainWindow w;
+    w.setApiEndpoints(ApiEndpoints::fromConfiguration(&parser));
+
+    // Wymuszenie sposobu rysowania wykresu (domyślnie automatycznie)
+    if (parser.isSet(openGlOption))
+        w.setChartRenderMode(MainWindow::ChartRenderMode::OpenGL);
+    else if (parser.isSet(softwareOption))
+        w.setChartRenderMode(MainWindow::ChartRenderMode::Software);
+
     w.show();
     return a.exec();
 }
@@ -8,12 +8,29 @@
 #include <QFile>
 #include <QDir>
 #include <QMessageBox>
+#include <QHeaderView>
+#include <QRegularExpression>
+#include <QOpenGLContext>
+#include <limits>
+#include "seriesfile.h"
+#include "downsampler.h"
+#include "measurementtablemodel.h"
+
+// Liczba stacji pokazywanych dla zapytania o najbliższe stacje
+static const int kNearestStationsCount = 5;
+
+// Łączna liczba rysowanych punktów (po decymacji), od której tryb Auto rysuje serie przez OpenGL
+static const qsizetype kOpenGLPointThreshold = 10000;
+
+// Liczba stacji z listy, których sensory i dane są pobierane w tle przed wyborem
+static const int kPrefetchStationCount = 3;
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
 {
     ui->setupUi(this);
+    stationHistory.load();
 
     // Logowanie wątku GUI dla weryfikacji wielowątkowości
     qDebug() << "MainWindow thread:" << QThread::currentThread();
@@ -29,9 +46,10 @@ MainWindow::MainWindow(QWidget *parent)
     qDebug() << "ApiWorker thread:" << apiWorker->thread();
 
     // Połączenie sygnałów ApiWorker z slotami MainWindow
-    connect(apiWorker, &ApiWorker::stationsFetched, this, &MainWindow::handleStationsFetched);
+    connect(apiWorker, &ApiWorker::stationCatalogReady, this, &MainWindow::handleStationCatalogReady);
     connect(apiWorker, &ApiWorker::sensorsFetched, this, &MainWindow::handleSensorsFetched);
-    connect(apiWorker, &ApiWorker::dataFetched, this, &MainWindow::handleDataFetched);
+    connect(apiWorker, &ApiWorker::seriesFetched, this, &MainWindow::handleSeriesFetched);
+    connect(apiWorker, &ApiWorker::stationSnapshotFetched, this, &MainWindow::handleStationSnapshotFetched);
     connect(apiWorker, &ApiWorker::networkError, this, &MainWindow::handleNetworkError);
 
     // Usuń istniejący QFrame
@@ -43,6 +61,7 @@ MainWindow::MainWindow(QWidget *parent)
     chartView->setObjectName("chartView");
     chartView->setGeometry(frameGeometry);
     chartView->setRenderHint(QPainter::Antialiasing);
+    chartView->setRubberBand(QChartView::HorizontalRubberBand); // przybliżanie zaznaczeniem, prawy przycisk oddala
     chartView->setFrameShape(QFrame::StyledPanel);
     chartView->setFrameShadow(QFrame::Raised);
 
@@ -58,6 +77,29 @@ MainWindow::MainWindow(QWidget *parent)
     oldChartFrame->setParent(nullptr);
     delete oldChartFrame;
 
+    // Tabela pomiarów - wiersze o stałej wysokości, żeby widok nie mierzył każdego z nich
+    tableModel = new MeasurementTableModel(this);
+    ui->tableWyniki->setModel(tableModel);
+    ui->tableWyniki->verticalHeader()->setVisible(false);
+    ui->tableWyniki->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    ui->tableWyniki->horizontalHeader()->setStretchLastSection(true);
+    ui->tableWyniki->setSelectionBehavior(QAbstractItemView::SelectRows);
+
+    // Jeden wykres i osie na cały czas życia okna - odświeżenie podmienia tylko punkty serii
+    chart = new QChart();
+    chartAxisX = new QDateTimeAxis();
+    chartAxisX->setFormat("dd.MM.yyyy");
+    chartAxisX->setTitleText("Data pomiaru");
+    chartAxisY = new QValueAxis();
+    chartAxisY->setLabelFormat("%.1f");
+    chart->addAxis(chartAxisX, Qt::AlignBottom);
+    chart->addAxis(chartAxisY, Qt::AlignLeft);
+    chartView->setChart(chart);
+
+    // Ponowna decymacja po przybliżeniu (zmiana zakresu osi X) i po zmianie rozmiaru wykresu
+    connect(chartAxisX, &QDateTimeAxis::rangeChanged, this, &MainWindow::redecimate);
+    connect(chart, &QChart::plotAreaChanged, this, &MainWindow::redecimate);
+
     // Inicjalizacja kombo z zakresami dat
     ui->comboZakres->addItems({
         "Ostatnia doba",
@@ -83,7 +125,7 @@ MainWindow::MainWindow(QWidget *parent)
         if (miasto.isEmpty()) return;
 
         miasto[0] = miasto[0].toUpper(); // pierwsza litera wielka
-        apiWorker->fetchStations(miasto);
+        inWorker([miasto](ApiWorker *worker) { worker->fetchStations(miasto); });
     });
 
     // Obsługa zmiany stacji - pobieranie sensorów
@@ -91,7 +133,16 @@ MainWindow::MainWindow(QWidget *parent)
         if (index < 0 || ui->comboStacje->currentData().isNull()) return;
 
         int stationId = ui->comboStacje->currentData().toInt();
-        apiWorker->fetchSensors(stationId);
+        // Poprzedni wybór stacji jest już nieaktualny
+        inWorker([stationId](ApiWorker *worker) { worker->fetchSensors(stationId, true); });
+    });
+
+    // Historia tylko wyborów użytkownika - automatyczny wybór pierwszej stacji jej nie zmienia
+    connect(ui->comboStacje, &QComboBox::activated, this, [=](int index) {
+        if (index < 0 || ui->comboStacje->itemData(index).isNull()) return;
+
+        stationHistory.recordUse(ui->comboStacje->itemData(index).toInt());
+        stationHistory.save();
     });
 
     // Obsługa zmian wyboru zakresu dat
@@ -109,36 +160,14 @@ MainWindow::MainWindow(QWidget *parent)
         if (miasto.isEmpty()) return;
         miasto[0] = miasto[0].toUpper();
 
-        // Wczytaj stacje.json
-        QFile stacjeFile("offline/stacje.json");
-        if (!stacjeFile.open(QIODevice::ReadOnly)) {
+        // Wczytaj stacje.json (tylko raz - potem korzystamy z katalogu w pamięci)
+        if (!loadOfflineCatalog()) {
             QMessageBox::warning(this, "Błąd", "Brak pliku offline/stacje.json");
             return;
         }
 
-        QByteArray stacjeData = stacjeFile.readAll();
-        stacjeFile.close();
-        QJsonDocument stacjeDoc = QJsonDocument::fromJson(stacjeData);
-        QJsonArray stacjeArray = stacjeDoc.array();
-
-        ui->comboStacje->clear();
-        bool found = false;
-
         // Szukamy stacji z podanego miasta
-        for (const QJsonValue &val : stacjeArray) {
-            QJsonObject ob = val.toObject();
-            if (ob.contains("city") && ob["city"].isObject()) {
-                QString cityName = ob["city"].toObject()["name"].toString();
-                if (cityName == miasto) {
-                    QString stationName = ob["stationName"].toString();
-                    int stationId = ob["id"].toInt();
-                    ui->comboStacje->addItem(stationName, stationId);
-                    found = true;
-                }
-            }
-        }
-
-        if (!found) {
+        if (showStationsForQuery(miasto) == 0) {
             QMessageBox::information(this, "Brak wyników", "Nie znaleziono stacji dla miasta.");
             return;
         }
@@ -183,7 +212,24 @@ MainWindow::MainWindow(QWidget *parent)
         int sensorId = ui->comboSensory->currentData().toInt();
         if (sensorId == 0) return;
 
-        apiWorker->fetchData(sensorId);
+        qint64 fromMs, toMs;
+        selectedRange(fromMs, toMs);
+        inWorker([sensorId, fromMs, toMs](ApiWorker *worker) { worker->fetchData(sensorId, fromMs, toMs, true); });
+    });
+
+    // Pobieranie danych wszystkich sensorów wybranej stacji
+    connect(ui->buttonPobierzWszystko, &QPushButton::clicked, this, [=]() {
+        if (ui->comboStacje->currentIndex() < 0 || ui->comboStacje->currentData().isNull()) {
+            QMessageBox::warning(this, "Uwaga", "Wybierz stację do pobrania danych");
+            return;
+        }
+
+        int stationId = ui->comboStacje->currentData().toInt();
+        if (stationId == 0) return;
+
+        qint64 fromMs, toMs;
+        selectedRange(fromMs, toMs);
+        inWorker([stationId, fromMs, toMs](ApiWorker *worker) { worker->fetchStationSnapshot(stationId, fromMs, toMs); });
     });
 }
 
@@ -197,28 +243,74 @@ MainWindow::~MainWindow()
     delete workerThread;
 }
 
-void MainWindow::handleStationsFetched(const QJsonArray &stations, const QString &city)
+void MainWindow::handleStationCatalogReady(const StationCatalog &catalog, const QString &city)
+{
+    stationCatalog = catalog;
+
+    if (showStationsForQuery(city) == 0)
+        ui->comboStacje->addItem("Brak wyników");
+    else
+        prefetchLikelyStations();
+}
+
+void MainWindow::prefetchLikelyStations()
+{
+    QVector<int> stationIds;
+    for (int i = 0; i < ui->comboStacje->count(); ++i)
+        stationIds.append(ui->comboStacje->itemData(i).toInt());
+    const QVector<int> likely = stationHistory.mostLikely(stationIds, kPrefetchStationCount);
+    inWorker([likely](ApiWorker *worker) { worker->prefetchStations(likely); });
+}
+
+int MainWindow::showStationsForQuery(const QString &city)
 {
     ui->comboStacje->clear();
 
-    for (const QJsonValue &val : stations) {
-        QJsonObject ob = val.toObject();
-        if (ob.contains("city") && ob["city"].isObject()) {
-            QString cityName = ob["city"].toObject()["name"].toString();
-            if (cityName == city) {
-                QString nazwa = ob["stationName"].toString();
-                int id = ob["id"].toInt();
-                ui->comboStacje->addItem(nazwa, id);
-            }
+    // Zamiast miasta można podać współrzędne "lat, lon" (najbliższe stacje)
+    // lub "lat, lon, promień_km" (wszystkie stacje w promieniu)
+    static const QRegularExpression coordinates(
+        R"(^\s*(-?\d+(?:\.\d+)?)\s*[,;\s]\s*(-?\d+(?:\.\d+)?)(?:\s*[,;\s]\s*(\d+(?:\.\d+)?))?\s*$)");
+    const QRegularExpressionMatch match = coordinates.match(city);
+    if (match.hasMatch()) {
+        const double lat = match.captured(1).toDouble();
+        const double lon = match.captured(2).toDouble();
+        const QVector<GeoMatch> matches = match.captured(3).isEmpty()
+            ? stationCatalog.nearestStations(lat, lon, kNearestStationsCount)
+            : stationCatalog.stationsWithinRadius(lat, lon, match.captured(3).toDouble());
+
+        for (const GeoMatch &geoMatch : matches) {
+            const Station *station = stationCatalog.stationById(geoMatch.id);
+            ui->comboStacje->addItem(station->name + QString(" (%1 km)").arg(geoMatch.distanceKm, 0, 'f', 1), geoMatch.id);
         }
+        return matches.size();
     }
 
-    if (ui->comboStacje->count() == 0)
-        ui->comboStacje->addItem("Brak wyników");
+    const QVector<int> stationIds = stationCatalog.stationIdsInCity(city);
+    for (int id : stationIds) {
+        const Station *station = stationCatalog.stationById(id);
+        ui->comboStacje->addItem(station->name, id);
+    }
+    return stationIds.size();
+}
+
+bool MainWindow::loadOfflineCatalog()
+{
+    if (!stationCatalog.isEmpty()) return true;
+
+    QFile stacjeFile("offline/stacje.json");
+    if (!stacjeFile.open(QIODevice::ReadOnly)) return false;
+
+    QJsonDocument stacjeDoc = QJsonDocument::fromJson(stacjeFile.readAll());
+    stacjeFile.close();
+    stationCatalog = StationCatalog::fromJson(stacjeDoc.array());
+    return !stationCatalog.isEmpty();
 }
 
 void MainWindow::handleSensorsFetched(const QJsonArray &sensors, int stationId)
 {
+    // Sensory stacji, którą użytkownik już opuścił, nie mogą zastąpić listy bieżącej stacji
+    if (stationId != ui->comboStacje->currentData().toInt()) return;
+
     ui->comboSensory->clear();
     for (const QJsonValue &val : sensors) {
         QJsonObject ob = val.toObject();
@@ -233,107 +325,244 @@ void MainWindow::handleSensorsFetched(const QJsonArray &sensors, int stationId)
 
 void MainWindow::handleDataFetched(const QJsonObject &data, int sensorId)
 {
-    QJsonArray values = data["values"].toArray();
+    showSeries(MeasurementSeries::fromJson(data, sensorId));
+}
 
-    // Ustalanie zakresu dat
-    QString zakres = ui->comboZakres->currentText();
-    QDateTime cutoff;
-    QDate fromDate, toDate;
-    bool customRange = (zakres == "Własny zakres");
+void MainWindow::handleSeriesFetched(const SeriesSlice &slice)
+{
+    // Spóźniona seria poprzednio wybranego sensora nie może nadpisać wykresu
+    if (slice.series.sensorId != ui->comboSensory->currentData().toInt()) return;
 
-    if (customRange) {
-        fromDate = ui->dateOd->date();
-        toDate = ui->dateDo->date();
-    } else if (zakres == "Ostatnia doba") {
-        cutoff = QDateTime::currentDateTime().addDays(-1);
-    } else if (zakres == "Ostatni tydzień") {
-        cutoff = QDateTime::currentDateTime().addDays(-7);
-    } else if (zakres == "Ostatni miesiąc") {
-        cutoff = QDateTime::currentDateTime().addMonths(-1);
-    } else if (zakres == "Ostatni rok") {
-        cutoff = QDateTime::currentDateTime().addYears(-1);
-    }
+    showSlice(slice);
+}
+
+void MainWindow::showSeries(const MeasurementSeries &measurements)
+{
+    qint64 fromMs, toMs;
+    selectedRange(fromMs, toMs);
+    showSlice(SeriesSlice::make(measurements, fromMs, toMs));
+}
+
+void MainWindow::showSlice(const SeriesSlice &slice)
+{
+    const MeasurementSeries &measurements = slice.series;
 
-    QLineSeries *series = new QLineSeries();
-    series->setName(ui->comboSensory->currentText());
+    // Tabela formatuje daty i wartości dopiero dla widocznych wierszy
+    tableModel->setSeries(measurements);
 
+    QList<QPointF> points;
+    points.reserve(measurements.size());
+    for (int i = 0; i < measurements.size(); ++i) {
+        if (!measurements.isNull(i))
+            points.append(QPointF(measurements.timestamps[i], measurements.values[i]));
+    }
+
+    // Statystyki (policzone już w wątku ApiWorker)
     QString output;
+    const SeriesStats &stats = slice.stats;
+    if (stats.count > 0) {
+        output += "📊 Statystyki:\n";
+        output += "🔺 Maksimum: " + QString::number(stats.max) + " (" + QDateTime::fromMSecsSinceEpoch(stats.maxTimestamp).toString("dd.MM.yyyy hh:mm") + ")\n";
+        output += "🔻 Minimum: " + QString::number(stats.min) + " (" + QDateTime::fromMSecsSinceEpoch(stats.minTimestamp).toString("dd.MM.yyyy hh:mm") + ")\n";
+        output += "📈 Średnia: " + QString::number(stats.mean, 'f', 2) + "\n";
+    }
 
-    // Zmienne do statystyk
-    double minValue = std::numeric_limits<double>::max();
-    double maxValue = std::numeric_limits<double>::min();
-    double sum = 0.0;
-    int count = 0;
-    QDateTime minTime, maxTime;
+    ui->textWyniki->setPlainText(output);
 
-    for (const QJsonValue &val : values) {
-        QJsonObject ob = val.toObject();
-        QDateTime dateTime = QDateTime::fromString(ob["date"].toString(), Qt::ISODate);
-        if (!dateTime.isValid()) continue;
+    // Aktualizacja wykresu - jedna seria, punkty trafiają do niej po decymacji (redecimate)
+    resizeChartTraces(1);
+    chartTraces[0].series->setName(ui->comboSensory->currentText());
+    chartTraces[0].points = points;
+    updateChart("Pomiary " + ui->comboSensory->currentText() + " - " + ui->comboStacje->currentText(),
+                ui->comboSensory->currentText());
+}
+
+void MainWindow::handleStationSnapshotFetched(const QJsonArray &sensors, int stationId, const QVector<SeriesSlice> &slices)
+{
+    // Wolna migawka stacji, którą użytkownik już opuścił, nie może nadpisać bieżącego widoku
+    if (stationId != ui->comboStacje->currentData().toInt()) return;
+
+    handleSensorsFetched(sensors, stationId);
+
+    QHash<int, QString> paramNames;
+    for (const QJsonValue &sensorVal : sensors) {
+        QJsonObject sensor = sensorVal.toObject();
+        paramNames.insert(sensor["id"].toInt(), sensor["param"].toObject()["paramName"].toString());
+    }
+
+    QString output = "📊 Statystyki stacji:\n";
+    tableModel->setSeries(MeasurementSeries());
+    resizeChartTraces(slices.size());
 
-        if (customRange) {
-            if (dateTime.date() < fromDate || dateTime.date() > toDate) continue;
+    for (int s = 0; s < slices.size(); ++s) {
+        const SeriesSlice &slice = slices[s];
+        const MeasurementSeries &measurements = slice.series;
+        QString paramName = paramNames.value(measurements.sensorId, measurements.key);
+
+        QList<QPointF> points;
+        points.reserve(measurements.size());
+        for (int i = 0; i < measurements.size(); ++i) {
+            if (!measurements.isNull(i))
+                points.append(QPointF(measurements.timestamps[i], measurements.values[i]));
+        }
+
+        chartTraces[s].series->setName(paramName);
+        chartTraces[s].points = points;
+
+        if (slice.stats.count > 0) {
+            output += paramName + ": min " + QString::number(slice.stats.min)
+                      + ", max " + QString::number(slice.stats.max)
+                      + ", średnia " + QString::number(slice.stats.mean, 'f', 2) + "\n";
         } else {
-            if (dateTime < cutoff) continue;
+            output += paramName + ": brak danych\n";
         }
+    }
 
-        // Dodaj do wyniku tekstowego
-        QString valueStr = ob["value"].isNull() ? "brak danych" : QString::number(ob["value"].toDouble());
-        output += dateTime.toString("dd.MM.yyyy hh:mm") + " → " + valueStr + "\n";
+    ui->textWyniki->setPlainText(output);
+    updateChart("Pomiary - " + ui->comboStacje->currentText(), "Wartość");
+}
 
-        // Dodaj do wykresu i statystyk
-        if (!ob["value"].isNull()) {
-            double value = ob["value"].toDouble();
-            series->append(dateTime.toMSecsSinceEpoch(), value);
+void MainWindow::resizeChartTraces(int count)
+{
+    // Serie są używane ponownie między odświeżeniami; tworzymy tylko brakujące
+    while (chartTraces.size() < count) {
+        QLineSeries *series = new QLineSeries();
+        chart->addSeries(series);
+        series->attachAxis(chartAxisX);
+        series->attachAxis(chartAxisY);
+        chartTraces.append({series, {}});
+    }
+    while (chartTraces.size() > count) {
+        QLineSeries *series = chartTraces.takeLast().series;
+        chart->removeSeries(series);
+        delete series;
+    }
+}
 
-            // Statystyki
-            if (value < minValue) {
-                minValue = value;
-                minTime = dateTime;
-            }
-            if (value > maxValue) {
-                maxValue = value;
-                maxTime = dateTime;
-            }
-            sum += value;
-            count++;
+void MainWindow::updateChart(const QString &title, const QString &axisYTitle)
+{
+    chart->setTitle(title);
+    chartAxisX->setFormat(ui->comboZakres->currentText() == "Ostatni rok" ? "MM.yyyy" : "dd.MM.yyyy");
+    chartAxisY->setTitleText(axisYTitle);
+
+    // Zakres osi liczymy z pełnych danych - po decymacji mogłoby zabraknąć skrajnych wartości
+    double minX = std::numeric_limits<double>::max();
+    double maxX = std::numeric_limits<double>::lowest();
+    double minY = std::numeric_limits<double>::max();
+    double maxY = std::numeric_limits<double>::lowest();
+    for (const ChartTrace &trace : std::as_const(chartTraces)) {
+        for (const QPointF &point : trace.points) {
+            minX = qMin(minX, point.x());
+            maxX = qMax(maxX, point.x());
+            minY = qMin(minY, point.y());
+            maxY = qMax(maxY, point.y());
         }
     }
 
-    // Dodaj statystyki do wyniku
-    if (count > 0) {
-        double average = sum / count;
-        output += "\n📊 Statystyki:\n";
-        output += "🔺 Maksimum: " + QString::number(maxValue) + " (" + maxTime.toString("dd.MM.yyyy hh:mm") + ")\n";
-        output += "🔻 Minimum: " + QString::number(minValue) + " (" + minTime.toString("dd.MM.yyyy hh:mm") + ")\n";
-        output += "📈 Średnia: " + QString::number(average, 'f', 2) + "\n";
+    // Zmiana zakresu osi X sama wywołuje redecimate (rangeChanged) - ręcznie tylko gdy zakres się nie zmienił
+    bool rangeChanged = false;
+    if (minX <= maxX) {
+        if (minY == maxY) {
+            minY -= 1.0;
+            maxY += 1.0;
+        }
+        const QDateTime rangeMin = QDateTime::fromMSecsSinceEpoch(qint64(minX));
+        const QDateTime rangeMax = QDateTime::fromMSecsSinceEpoch(qint64(maxX));
+        rangeChanged = chartAxisX->min() != rangeMin || chartAxisX->max() != rangeMax;
+        chartAxisX->setRange(rangeMin, rangeMax);
+        chartAxisY->setRange(minY, maxY);
     }
 
-    ui->textWyniki->setPlainText(output);
+    if (!rangeChanged)
+        redecimate();
+}
+
+void MainWindow::setApiEndpoints(const ApiEndpoints &endpoints)
+{
+    inWorker([endpoints](ApiWorker *worker) { worker->setEndpoints(endpoints); });
+}
 
-    // Tworzenie wykresu
-    QChart *chart = new QChart();
-    chart->addSeries(series);
-    chart->setTitle("Pomiary " + ui->comboSensory->currentText() + " - " + ui->comboStacje->currentText());
+void MainWindow::setChartRenderMode(ChartRenderMode mode)
+{
+    renderMode = mode;
+}
 
-    QDateTimeAxis *axisX = new QDateTimeAxis();
-    if (zakres == "Ostatni rok") {
-        axisX->setFormat("MM.yyyy");
-    } else {
-        axisX->setFormat("dd.MM.yyyy");
+MainWindow::ChartRenderMode MainWindow::chartRenderMode() const
+{
+    return renderMode;
+}
+
+bool MainWindow::chartUsesOpenGL(qsizetype pointCount) const
+{
+    switch (renderMode) {
+    case ChartRenderMode::Software:
+        return false;
+    case ChartRenderMode::OpenGL:
+        return openGlAvailable();
+    case ChartRenderMode::Auto:
+        break;
     }
-    axisX->setTitleText("Data pomiaru");
+    return pointCount > kOpenGLPointThreshold && openGlAvailable();
+}
 
-    QValueAxis *axisY = new QValueAxis();
-    axisY->setLabelFormat("%.1f");
-    axisY->setTitleText(ui->comboSensory->currentText());
+bool MainWindow::openGlAvailable()
+{
+    // Próbny kontekst; przy braku GPU Qt może użyć programowego OpenGL (QT_OPENGL=software)
+    static const bool available = [] {
+        QOpenGLContext context;
+        const bool created = context.create();
+        if (!created)
+            qWarning() << "OpenGL niedostępny - wykres rysowany programowo";
+        return created;
+    }();
+    return available;
+}
 
-    chart->addAxis(axisX, Qt::AlignBottom);
-    chart->addAxis(axisY, Qt::AlignLeft);
-    series->attachAxis(axisX);
-    series->attachAxis(axisY);
+void MainWindow::redecimate()
+{
+    const double minX = chartAxisX->min().toMSecsSinceEpoch();
+    const double maxX = chartAxisX->max().toMSecsSinceEpoch();
+
+    // Jeden punkt na piksel obszaru wykresu; przed pierwszym ułożeniem bierzemy szerokość widoku
+    int width = int(chart->plotArea().width());
+    if (width <= 0) width = chartView->width();
+
+    QVector<QList<QPointF>> decimated;
+    decimated.reserve(chartTraces.size());
+    qsizetype drawnCount = 0;
+    for (const ChartTrace &trace : std::as_const(chartTraces)) {
+        decimated.append(Downsampler::lttb(Downsampler::visible(trace.points, minX, maxX), width));
+        drawnCount += decimated.last().size();
+    }
 
-    chartView->setChart(chart);
+    // O trybie rysowania decyduje liczba punktów faktycznie rysowanych, a nie surowych
+    const bool useOpenGL = chartUsesOpenGL(drawnCount);
+    for (int i = 0; i < chartTraces.size(); ++i) {
+        chartTraces[i].series->setUseOpenGL(useOpenGL);
+        chartTraces[i].series->replace(decimated[i]);
+    }
+}
+
+void MainWindow::selectedRange(qint64 &fromMs, qint64 &toMs) const
+{
+    QString zakres = ui->comboZakres->currentText();
+    QDateTime from, to;
+
+    if (zakres == "Własny zakres") {
+        from = ui->dateOd->date().startOfDay();
+        to = ui->dateDo->date().endOfDay();
+    } else if (zakres == "Ostatnia doba") {
+        from = QDateTime::currentDateTime().addDays(-1);
+    } else if (zakres == "Ostatni tydzień") {
+        from = QDateTime::currentDateTime().addDays(-7);
+    } else if (zakres == "Ostatni miesiąc") {
+        from = QDateTime::currentDateTime().addMonths(-1);
+    } else if (zakres == "Ostatni rok") {
+        from = QDateTime::currentDateTime().addYears(-1);
+    }
+
+    fromMs = from.isValid() ? from.toMSecsSinceEpoch() : std::numeric_limits<qint64>::min();
+    toMs = to.isValid() ? to.toMSecsSinceEpoch() : std::numeric_limits<qint64>::max();
 }
 
 void MainWindow::handleNetworkError(const QString &errorString)
@@ -342,17 +571,9 @@ void MainWindow::handleNetworkError(const QString &errorString)
 
     // Próba wczytania danych offline
     QString miasto = ui->inputMiasto->text().trimmed();
-    if (!miasto.isEmpty()) {
-        miasto[0] = miasto[0].toUpper();
-        QFile stacjeFile("offline/stacje.json");
-        if (stacjeFile.open(QIODevice::ReadOnly)) {
-            QByteArray stacjeData = stacjeFile.readAll();
-            stacjeFile.close();
-            QJsonDocument stacjeDoc = QJsonDocument::fromJson(stacjeData);
-            QJsonArray stacjeArray = stacjeDoc.array();
-
-            handleStationsFetched(stacjeArray, miasto);
-        }
+    if (!miasto.isEmpty() && loadOfflineCatalog()) {
+        if (showStationsForQuery(miasto) == 0)
+            ui->comboStacje->addItem("Brak wyników");
     }
 
     int stationId = ui->comboStacje->currentData().toInt();
@@ -373,8 +594,12 @@ void MainWindow::handleNetworkError(const QString &errorString)
 
     int sensorId = ui->comboSensory->currentData().toInt();
     if (sensorId > 0) {
+        // Binarny plik serii mapujemy bez parsowania; JSON to format starszych wersji aplikacji
+        SeriesFile seriesFile;
         QString fileName = "offline/dane_" + QString::number(sensorId) + ".json";
-        if (QFile::exists(fileName)) {
+        if (seriesFile.open(SeriesFile::offlinePath(sensorId))) {
+            showSeries(seriesFile.toSeries());
+        } else if (QFile::exists(fileName)) {
             QFile file(fileName);
             if (file.open(QIODevice::ReadOnly)) {
                 QByteArray data = file.readAll();
@@ -4,6 +4,11 @@
 #include <QMainWindow>
 #include <QThread>
 #include "apiworker.h"
+#include "stationcatalog.h"
+#include "stationhistory.h"
+#include "measurementseries.h"
+
+class MeasurementTableModel;
 
 #include <QtCharts>
 
@@ -40,16 +45,44 @@ public:
      */
     ~MainWindow();
 
+    /**
+     * @brief Ustawia adres bazowy i ścieżki endpointów API używane przez ApiWorker.
+     * @param endpoints Konfiguracja endpointów.
+     */
+    void setApiEndpoints(const ApiEndpoints &endpoints);
+
+    /**
+     * @brief Sposób rysowania serii na wykresie.
+     */
+    enum class ChartRenderMode {
+        Auto,     /**< OpenGL powyżej progu liczby rysowanych (zdecymowanych) punktów, poniżej programowo. */
+        Software, /**< Zawsze rysowanie programowe (QPainter z antyaliasingiem). */
+        OpenGL    /**< Zawsze OpenGL, jeśli jest dostępny. */
+    };
+
+    /**
+     * @brief Ustawia sposób rysowania serii; obowiązuje od następnego wykresu.
+     * @param mode Tryb rysowania.
+     */
+    void setChartRenderMode(ChartRenderMode mode);
+
+    /**
+     * @brief Zwraca bieżący sposób rysowania serii.
+     */
+    ChartRenderMode chartRenderMode() const;
+
 private slots:
     /**
-     * @brief Obsługuje dane stacji pobrane przez ApiWorker.
-     * @param stations Tablica JSON z danymi stacji.
+     * @brief Zapamiętuje katalog stacji pobrany przez ApiWorker i pokazuje stacje miasta.
+     * @param catalog Katalog stacji.
      * @param city Miasto, dla którego pobrano stacje.
      */
-    void handleStationsFetched(const QJsonArray &stations, const QString &city);
+    void handleStationCatalogReady(const StationCatalog &catalog, const QString &city);
 
     /**
      * @brief Obsługuje dane sensorów pobrane przez ApiWorker.
+     *
+     * Ignoruje sensory stacji innej niż wybrana w comboStacje.
      * @param sensors Tablica JSON z danymi sensorów.
      * @param stationId Identyfikator stacji.
      */
@@ -62,17 +95,132 @@ private slots:
      */
     void handleDataFetched(const QJsonObject &data, int sensorId);
 
+    /**
+     * @brief Wyświetla serię przygotowaną przez ApiWorker (przyciętą, ze statystykami).
+     *
+     * Ignoruje serię sensora innego niż wybrany w comboSensory.
+     * @param slice Seria pomiarowa w wybranym zakresie dat.
+     */
+    void handleSeriesFetched(const SeriesSlice &slice);
+
+    /**
+     * @brief Obsługuje komplet danych stacji pobrany przez ApiWorker i rysuje wszystkie parametry.
+     *
+     * Migawka stacji innej niż wybrana w comboStacje jest pomijana.
+     * @param sensors Tablica JSON z danymi sensorów.
+     * @param stationId Identyfikator stacji.
+     * @param slices Serie sensorów przycięte do zakresu dat, ze statystykami.
+     */
+    void handleStationSnapshotFetched(const QJsonArray &sensors, int stationId, const QVector<SeriesSlice> &slices);
+
     /**
      * @brief Obsługuje błędy sieciowe.
      * @param errorString Opis błędu.
      */
     void handleNetworkError(const QString &errorString);
 
+    /**
+     * @brief Ponownie decymuje serie wykresu do widocznego zakresu osi X i szerokości wykresu
+     *        i wybiera tryb rysowania według liczby punktów po decymacji.
+     */
+    void redecimate();
+
 private:
+    /**
+     * @struct ChartTrace
+     * @brief Seria na wykresie wraz z jej pełnymi danymi.
+     */
+    struct ChartTrace {
+        QLineSeries *series;   /**< Seria na wykresie (punkty po decymacji). */
+        QList<QPointF> points; /**< Wszystkie punkty serii w pełnej rozdzielczości. */
+    };
+
+    /**
+     * @brief Wyznacza zakres czasu wybrany w comboZakres (lub w polach dat).
+     * @param fromMs Początek zakresu w ms od epoki (minimum qint64, jeśli brak ograniczenia).
+     * @param toMs Koniec zakresu w ms od epoki (maksimum qint64, jeśli brak ograniczenia).
+     */
+    void selectedRange(qint64 &fromMs, qint64 &toMs) const;
+
+    /**
+     * @brief Przycina serię do wybranego zakresu dat i ją wyświetla (ścieżka offline).
+     * @param measurements Pełna seria pomiarowa sensora.
+     */
+    void showSeries(const MeasurementSeries &measurements);
+
+    /**
+     * @brief Wyświetla listę punktów, statystyki i wykres gotowej serii.
+     * @param slice Seria przycięta do zakresu dat, ze statystykami.
+     */
+    void showSlice(const SeriesSlice &slice);
+
+    /**
+     * @brief Dopasowuje liczbę serii na wykresie, używając ponownie istniejących.
+     * @param count Wymagana liczba serii.
+     */
+    void resizeChartTraces(int count);
+
+    /**
+     * @brief Odświeża wykres po zmianie punktów w chartTraces: tytuły, zakres osi z pełnych
+     *        danych i decymację (z trybem rysowania). Nie tworzy nowego wykresu ani osi.
+     * @param title Tytuł wykresu.
+     * @param axisYTitle Opis osi wartości.
+     */
+    void updateChart(const QString &title, const QString &axisYTitle);
+
+    /**
+     * @brief Sprawdza, czy wykres o podanej liczbie punktów ma być rysowany przez OpenGL.
+     * @param pointCount Łączna liczba rysowanych punktów wszystkich serii (po decymacji).
+     */
+    bool chartUsesOpenGL(qsizetype pointCount) const;
+
+    /**
+     * @brief Sprawdza (raz na proces), czy da się utworzyć kontekst OpenGL.
+     * @return false, gdy brak sterownika GPU i programowego OpenGL - wtedy wykres rysuje QPainter.
+     */
+    static bool openGlAvailable();
+
+    /**
+     * @brief Wypełnia comboStacje stacjami z katalogu.
+     * @param city Nazwa miasta albo współrzędne "lat, lon" (najbliższe stacje)
+     *             lub "lat, lon, promień_km" (stacje w promieniu).
+     * @return Liczba znalezionych stacji.
+     */
+    int showStationsForQuery(const QString &city);
+
+    /**
+     * @brief Wczytuje katalog z offline/stacje.json, jeśli nie ma go jeszcze w pamięci.
+     * @return true, jeśli katalog jest dostępny.
+     */
+    bool loadOfflineCatalog();
+
+    /**
+     * @brief Zleca w tle prefetch najczęściej wybieranych stacji z comboStacje.
+     */
+    void prefetchLikelyStations();
+
+    /**
+     * @brief Wywołuje funkcję na ApiWorker w jego wątku (Qt::QueuedConnection).
+     * @param call Funkcja przyjmująca wskaźnik na ApiWorker.
+     */
+    template <typename Call>
+    void inWorker(Call call) {
+        ApiWorker *worker = apiWorker;
+        QMetaObject::invokeMethod(worker, [worker, call]() { call(worker); }, Qt::QueuedConnection);
+    }
+
     Ui::MainWindow *ui; /**< Wskaźnik na interfejs użytkownika. */
     QChartView *chartView; /**< Wskaźnik na widok wykresu. */
+    MeasurementTableModel *tableModel; /**< Model tabeli pomiarów wyświetlanej serii. */
+    QChart *chart; /**< Wykres używany przez cały czas życia okna. */
+    QDateTimeAxis *chartAxisX; /**< Oś czasu wykresu. */
+    QValueAxis *chartAxisY; /**< Oś wartości wykresu. */
     QThread *workerThread; /**< Wątek dla ApiWorker. */
     ApiWorker *apiWorker; /**< Instancja ApiWorker do pobierania danych. */
+    StationCatalog stationCatalog; /**< Katalog stacji wspólny dla trybu online i offline. */
+    StationHistory stationHistory; /**< Historia wyborów stacji (kolejność prefetchu). */
+    QVector<ChartTrace> chartTraces; /**< Serie bieżącego wykresu z danymi w pełnej rozdzielczości. */
+    ChartRenderMode renderMode = ChartRenderMode::Auto; /**< Sposób rysowania serii. */
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,111 @@
+#include "measurementseries.h"
+#include "timestampparser.h"
+#include <QDateTime>
+#include <QJsonArray>
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+MeasurementSeries MeasurementSeries::fromJson(const QJsonObject &data, int sensorId) {
+    const QJsonArray values = data.value("values").toArray();
+    QVector<qint64> timestamps;
+    QVector<double> parsedValues;
+    timestamps.reserve(values.size());
+    parsedValues.reserve(values.size());
+
+    TimestampParser parser;
+    for (const QJsonValue &val : values) {
+        const QJsonObject ob = val.toObject();
+        const QString date = ob.value("date").toString();
+        qint64 timestamp;
+        // Format inny niż "yyyy-MM-dd HH:mm:ss" - wolniejsza, ogólna ścieżka
+        if (!parser.parse(date, timestamp) && !TimestampParser::parseIso(date, timestamp))
+            continue;
+
+        const QJsonValue value = ob.value("value");
+        timestamps.append(timestamp);
+        parsedValues.append(value.isNull() ? std::numeric_limits<double>::quiet_NaN() : value.toDouble());
+    }
+
+    return fromPoints(sensorId, data.value("key").toString(), timestamps, parsedValues);
+}
+
+MeasurementSeries MeasurementSeries::fromPoints(int sensorId, const QString &key,
+                                                const QVector<qint64> &timestamps, const QVector<double> &values) {
+    MeasurementSeries series;
+    series.sensorId = sensorId;
+    series.key = key;
+
+    // API zwraca pomiary od najnowszego; porządkujemy rosnąco
+    QVector<int> order(timestamps.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&timestamps](int a, int b) { return timestamps[a] < timestamps[b]; });
+
+    series.timestamps.reserve(order.size());
+    series.values.reserve(order.size());
+    for (int index : std::as_const(order)) {
+        series.timestamps.append(timestamps[index]);
+        series.values.append(values[index]);
+    }
+    return series;
+}
+
+QJsonObject MeasurementSeries::toJson() const {
+    const QTimeZone zone = TimestampParser::apiTimeZone();
+    QJsonArray points;
+    for (int i = size() - 1; i >= 0; --i) {
+        QJsonObject point;
+        point["date"] = QDateTime::fromMSecsSinceEpoch(timestamps[i], zone).toString("yyyy-MM-dd HH:mm:ss");
+        point["value"] = isNull(i) ? QJsonValue() : QJsonValue(values[i]);
+        points.append(point);
+    }
+
+    QJsonObject data;
+    data["key"] = key;
+    data["values"] = points;
+    return data;
+}
+
+MeasurementSeries MeasurementSeries::slice(qint64 fromMs, qint64 toMs) const {
+    MeasurementSeries result;
+    result.sensorId = sensorId;
+    result.key = key;
+
+    const auto first = std::lower_bound(timestamps.cbegin(), timestamps.cend(), fromMs);
+    const auto last = std::upper_bound(first, timestamps.cend(), toMs);
+    const qsizetype begin = first - timestamps.cbegin();
+    const qsizetype length = last - first;
+    result.timestamps = timestamps.mid(begin, length);
+    result.values = values.mid(begin, length);
+    return result;
+}
+
+SeriesStats SeriesStats::compute(const MeasurementSeries &series) {
+    SeriesStats stats;
+    double sum = 0.0;
+    for (int i = 0; i < series.size(); ++i) {
+        if (series.isNull(i)) continue;
+
+        const double value = series.values[i];
+        if (stats.count == 0 || value < stats.min) {
+            stats.min = value;
+            stats.minTimestamp = series.timestamps[i];
+        }
+        if (stats.count == 0 || value > stats.max) {
+            stats.max = value;
+            stats.maxTimestamp = series.timestamps[i];
+        }
+        sum += value;
+        ++stats.count;
+    }
+    if (stats.count > 0)
+        stats.mean = sum / stats.count;
+    return stats;
+}
+
+SeriesSlice SeriesSlice::make(const MeasurementSeries &full, qint64 fromMs, qint64 toMs) {
+    SeriesSlice slice;
+    slice.series = full.slice(fromMs, toMs);
+    slice.stats = SeriesStats::compute(slice.series);
+    return slice;
+}
@@ -0,0 +1,110 @@
+#ifndef MEASUREMENTSERIES_H
+#define MEASUREMENTSERIES_H
+
+#include <QJsonObject>
+#include <QMetaType>
+#include <QString>
+#include <QVector>
+#include <cmath>
+#include <limits>
+
+/**
+ * @struct MeasurementSeries
+ * @brief Zwarta seria pomiarowa jednego sensora w układzie kolumnowym.
+ *
+ * Znaczniki czasu są posortowane rosnąco i wyrażone w milisekundach od epoki,
+ * tak jak oczekuje ich QLineSeries. Brak pomiaru ("value": null) to NaN.
+ */
+struct MeasurementSeries {
+    int sensorId = 0;           /**< Identyfikator sensora. */
+    QString key;                /**< Kod parametru z API, np. "PM10". */
+    QVector<qint64> timestamps; /**< Znaczniki czasu w ms od epoki, rosnąco. */
+    QVector<double> values;     /**< Wartości pomiarów; NaN oznacza brak danych. */
+
+    /**
+     * @brief Liczba punktów serii.
+     */
+    int size() const { return timestamps.size(); }
+
+    /**
+     * @brief Sprawdza, czy punkt nie ma wartości.
+     * @param index Indeks punktu.
+     */
+    bool isNull(int index) const { return std::isnan(values.at(index)); }
+
+    /**
+     * @brief Buduje serię z odpowiedzi data/getData.
+     * @param data Obiekt JSON z kluczem "key" i tablicą "values".
+     * @param sensorId Identyfikator sensora.
+     * @return Seria posortowana rosnąco po czasie.
+     */
+    static MeasurementSeries fromJson(const QJsonObject &data, int sensorId);
+
+    /**
+     * @brief Buduje serię z punktów w kolejności z API (od najnowszego).
+     * @param sensorId Identyfikator sensora.
+     * @param key Kod parametru.
+     * @param timestamps Znaczniki czasu w ms od epoki, w dowolnej kolejności.
+     * @param values Wartości odpowiadające znacznikom czasu.
+     * @return Seria posortowana rosnąco po czasie.
+     */
+    static MeasurementSeries fromPoints(int sensorId, const QString &key,
+                                        const QVector<qint64> &timestamps, const QVector<double> &values);
+
+    /**
+     * @brief Odtwarza obiekt JSON w kształcie odpowiedzi data/getData (pomiary od najnowszego).
+     */
+    QJsonObject toJson() const;
+
+    /**
+     * @brief Zwraca punkty z zakresu [fromMs, toMs] (wyszukiwanie binarne po czasie).
+     * @param fromMs Początek zakresu w ms od epoki.
+     * @param toMs Koniec zakresu w ms od epoki.
+     */
+    MeasurementSeries slice(qint64 fromMs, qint64 toMs) const;
+};
+
+/**
+ * @struct SeriesStats
+ * @brief Statystyki serii liczone po punktach z wartością.
+ */
+struct SeriesStats {
+    int count = 0;            /**< Liczba punktów z wartością. */
+    double min = 0.0;         /**< Wartość minimalna. */
+    double max = 0.0;         /**< Wartość maksymalna. */
+    double mean = 0.0;        /**< Średnia. */
+    qint64 minTimestamp = 0;  /**< Czas wystąpienia minimum (ms od epoki). */
+    qint64 maxTimestamp = 0;  /**< Czas wystąpienia maksimum (ms od epoki). */
+
+    /**
+     * @brief Liczy statystyki serii.
+     * @param series Seria pomiarowa.
+     */
+    static SeriesStats compute(const MeasurementSeries &series);
+};
+
+/**
+ * @struct SeriesSlice
+ * @brief Seria przycięta do zakresu dat wraz z gotowymi statystykami.
+ *
+ * Produkowana w wątku ApiWorker, dzięki czemu GUI tylko wyświetla gotowy wynik.
+ */
+struct SeriesSlice {
+    MeasurementSeries series; /**< Punkty w zakresie, w pełnej rozdzielczości. */
+    SeriesStats stats;        /**< Statystyki punktów w zakresie. */
+
+    /**
+     * @brief Przycina serię do zakresu i liczy statystyki.
+     * @param full Pełna seria.
+     * @param fromMs Początek zakresu w ms od epoki.
+     * @param toMs Koniec zakresu w ms od epoki.
+     */
+    static SeriesSlice make(const MeasurementSeries &full,
+                            qint64 fromMs = std::numeric_limits<qint64>::min(),
+                            qint64 toMs = std::numeric_limits<qint64>::max());
+};
+
+Q_DECLARE_METATYPE(MeasurementSeries)
+Q_DECLARE_METATYPE(SeriesSlice)
+
+#endif // MEASUREMENTSERIES_H
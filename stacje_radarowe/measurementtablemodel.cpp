@@ -0,0 +1,51 @@
+#include "measurementtablemodel.h"
+#include <QDateTime>
+
+MeasurementTableModel::MeasurementTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+void MeasurementTableModel::setSeries(const MeasurementSeries &series) {
+    beginResetModel();
+    measurements = series;
+    endResetModel();
+}
+
+int MeasurementTableModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : measurements.size();
+}
+
+int MeasurementTableModel::columnCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant MeasurementTableModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= measurements.size())
+        return QVariant();
+
+    const int row = index.row();
+    if (role == Qt::DisplayRole) {
+        if (index.column() == DateColumn)
+            return QDateTime::fromMSecsSinceEpoch(measurements.timestamps[row]).toString("dd.MM.yyyy hh:mm");
+        if (index.column() == ValueColumn)
+            return measurements.isNull(row) ? QStringLiteral("brak danych") : QString::number(measurements.values[row]);
+    } else if (role == Qt::TextAlignmentRole && index.column() == ValueColumn) {
+        return QVariant(Qt::AlignRight | Qt::AlignVCenter);
+    }
+    return QVariant();
+}
+
+QVariant MeasurementTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal)
+        return QAbstractTableModel::headerData(section, orientation, role);
+
+    switch (section) {
+    case DateColumn:
+        return QStringLiteral("Data pomiaru");
+    case ValueColumn:
+        return QStringLiteral("Wartość");
+    default:
+        return QVariant();
+    }
+}
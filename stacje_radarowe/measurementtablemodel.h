@@ -0,0 +1,54 @@
+#ifndef MEASUREMENTTABLEMODEL_H
+#define MEASUREMENTTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include "measurementseries.h"
+
+/**
+ * @class MeasurementTableModel
+ * @brief Model tabeli pomiarów (data, wartość) nad serią pomiarową.
+ *
+ * Model trzyma tylko serię (współdzielone kolumny QVector), a tekst daty i wartości
+ * formatuje dopiero w data(), więc QTableView formatuje jedynie widoczne wiersze.
+ */
+class MeasurementTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Kolumny tabeli.
+     */
+    enum Column {
+        DateColumn = 0, /**< Data i godzina pomiaru. */
+        ValueColumn,    /**< Wartość pomiaru lub "brak danych". */
+        ColumnCount
+    };
+
+    /**
+     * @brief Tworzy pusty model.
+     * @param parent Rodzic obiektu.
+     */
+    explicit MeasurementTableModel(QObject *parent = nullptr);
+
+    /**
+     * @brief Podmienia serię wyświetlaną w tabeli.
+     * @param series Seria pomiarowa posortowana rosnąco po czasie.
+     */
+    void setSeries(const MeasurementSeries &series);
+
+    /**
+     * @brief Zwraca wyświetlaną serię.
+     */
+    const MeasurementSeries &series() const { return measurements; }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    MeasurementSeries measurements; /**< Wyświetlana seria. */
+};
+
+#endif // MEASUREMENTTABLEMODEL_H
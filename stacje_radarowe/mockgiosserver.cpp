@@ -0,0 +1,192 @@
+#include "mockgiosserver.h"
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPointer>
+#include <QTimeZone>
+#include <QTcpSocket>
+#include <QTimer>
+#include <cmath>
+#include <cstring>
+
+static const char *const kApiPrefix = "/pjp-api/rest/";
+
+static const char *const kCities[] = {"Warszawa", "Kraków", "Łódź", "Wrocław", "Poznań", "Gdańsk"};
+static const char *const kParamCodes[] = {"PM10", "PM2.5", "NO2", "O3", "SO2"};
+
+MockGiosServer::MockGiosServer(QObject *parent)
+    : QTcpServer(parent), rng(1)
+{
+    connect(this, &QTcpServer::newConnection, this, &MockGiosServer::onNewConnection);
+}
+
+bool MockGiosServer::start(quint16 port) {
+    return listen(QHostAddress::LocalHost, port);
+}
+
+QUrl MockGiosServer::baseUrl() const {
+    return QUrl(QString("http://127.0.0.1:%1%2").arg(serverPort()).arg(kApiPrefix));
+}
+
+void MockGiosServer::onNewConnection() {
+    while (QTcpSocket *socket = nextPendingConnection()) {
+        connect(socket, &QTcpSocket::readyRead, this, &MockGiosServer::onReadyRead);
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            buffers.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void MockGiosServer::onReadyRead() {
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    QByteArray &buffer = buffers[socket];
+    buffer += socket->readAll();
+
+    // Żądania GET nie mają ciała - każde kończy się pustą linią
+    qsizetype end;
+    while ((end = buffer.indexOf("\r\n\r\n")) >= 0) {
+        const QByteArray head = buffer.left(end);
+        buffer.remove(0, end + 4);
+
+        const QList<QByteArray> lines = head.split('\n');
+        const QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+        const QString path = requestLine.size() >= 2 ? QString::fromLatin1(requestLine[1]) : QString();
+
+        QByteArray ifNoneMatch;
+        for (const QByteArray &line : lines) {
+            const qsizetype colon = line.indexOf(':');
+            if (colon > 0 && line.left(colon).trimmed().toLower() == "if-none-match")
+                ifNoneMatch = line.mid(colon + 1).trimmed();
+        }
+        respond(socket, QUrl(path).path(), ifNoneMatch);
+    }
+}
+
+void MockGiosServer::respond(QTcpSocket *socket, const QString &path, const QByteArray &ifNoneMatch) {
+    ++requests;
+    maxInFlight = qMax(maxInFlight, ++inFlight);
+
+    const int delay = latencyMs + (jitterMs > 0 ? int(rng.bounded(jitterMs + 1)) : 0);
+    const bool fail = errorRate > 0.0 && rng.generateDouble() < errorRate;
+
+    QPointer<QTcpSocket> target(socket);
+    QTimer::singleShot(delay, this, [this, target, path, ifNoneMatch, fail]() {
+        --inFlight;
+        if (!target || target->state() != QAbstractSocket::ConnectedState) return;
+
+        QByteArray body;
+        QByteArray status = "200 OK";
+        if (fail) {
+            status = "503 Service Unavailable";
+            body = "{\"error\":\"mock failure\"}";
+        } else if (!path.startsWith(kApiPrefix) || !buildBody(path.mid(int(strlen(kApiPrefix))), body)) {
+            status = "404 Not Found";
+            body = "{\"error\":\"not found\"}";
+        }
+
+        // Treść jest deterministyczna, więc jej skrót wystarcza jako ETag
+        QByteArray etag;
+        if (status == "200 OK") {
+            etag = '"' + QByteArray::number(qHash(body), 16) + '"';
+            if (ifNoneMatch == etag) {
+                status = "304 Not Modified";
+                body.clear();
+                ++notModified;
+            }
+        }
+
+        QByteArray header = "HTTP/1.1 " + status + "\r\n"
+                            "Content-Type: application/json;charset=UTF-8\r\n"
+                            "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+        if (!etag.isEmpty())
+            header += "ETag: " + etag + "\r\n";
+        header += "Connection: keep-alive\r\n\r\n";
+        target->write(header);
+        target->write(body);
+        sentBytes += body.size();
+    });
+}
+
+bool MockGiosServer::buildBody(const QString &path, QByteArray &body) const {
+    if (!datasetDir.isEmpty()) {
+        QFile file(datasetDir + kApiPrefix + path);
+        if (!file.open(QIODevice::ReadOnly)) return false;
+        body = file.readAll();
+        return true;
+    }
+
+    if (path == "station/findAll") {
+        body = stationsJson();
+        return true;
+    }
+    bool ok = false;
+    if (path.startsWith("station/sensors/")) {
+        const int stationId = path.mid(16).toInt(&ok);
+        if (!ok || stationId < 1 || stationId > stationCount) return false;
+        body = sensorsJson(stationId);
+        return true;
+    }
+    if (path.startsWith("data/getData/")) {
+        const int sensorId = path.mid(13).toInt(&ok);
+        if (!ok || sensorId <= 0) return false;
+        body = dataJson(sensorId);
+        return true;
+    }
+    return false;
+}
+
+QByteArray MockGiosServer::stationsJson() const {
+    const int cityCount = int(sizeof(kCities) / sizeof(kCities[0]));
+    QJsonArray stations;
+    for (int id = 1; id <= stationCount; ++id) {
+        QJsonObject city;
+        city["id"] = (id - 1) % cityCount + 1;
+        city["name"] = kCities[(id - 1) % cityCount];
+        QJsonObject station;
+        station["id"] = id;
+        station["stationName"] = QString("%1, Stacja %2").arg(kCities[(id - 1) % cityCount]).arg(id);
+        station["gegrLat"] = QString::number(50.0 + (id % 40) * 0.1, 'f', 6);
+        station["gegrLon"] = QString::number(16.0 + (id % 70) * 0.1, 'f', 6);
+        station["city"] = city;
+        stations.append(station);
+    }
+    return QJsonDocument(stations).toJson(QJsonDocument::Compact);
+}
+
+// Sensory stacji mają ID stationId * 100 + k, więc getData zna parametr bez stanu
+QByteArray MockGiosServer::sensorsJson(int stationId) const {
+    const int paramCount = int(sizeof(kParamCodes) / sizeof(kParamCodes[0]));
+    QJsonArray sensors;
+    for (int k = 0; k < sensorsPerStation; ++k) {
+        QJsonObject param;
+        param["paramCode"] = kParamCodes[k % paramCount];
+        param["paramName"] = kParamCodes[k % paramCount];
+        QJsonObject sensor;
+        sensor["id"] = stationId * 100 + k;
+        sensor["stationId"] = stationId;
+        sensor["param"] = param;
+        sensors.append(sensor);
+    }
+    return QJsonDocument(sensors).toJson(QJsonDocument::Compact);
+}
+
+QByteArray MockGiosServer::dataJson(int sensorId) const {
+    const int paramCount = int(sizeof(kParamCodes) / sizeof(kParamCodes[0]));
+    QDateTime time = QDateTime::currentDateTime(QTimeZone("Europe/Warsaw"));
+    time.setTime(QTime(time.time().hour(), 0));
+
+    QByteArray out = "{\"key\":\"" + QByteArray(kParamCodes[(sensorId % 100) % paramCount]) + "\",\"values\":[";
+    for (int i = 0; i < dataPoints; ++i) {
+        if (i > 0) out += ',';
+        out += "{\"date\":\"" + time.addSecs(-3600LL * i).toString("yyyy-MM-dd HH:mm:ss").toLatin1() + "\",\"value\":";
+        if (i % 50 == 49)
+            out += "null}";
+        else
+            out += QByteArray::number(20.0 + 10.0 * std::sin((i + sensorId) / 24.0), 'f', 1) + '}';
+    }
+    out += "]}";
+    return out;
+}
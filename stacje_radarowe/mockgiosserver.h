@@ -0,0 +1,105 @@
+#ifndef MOCKGIOSSERVER_H
+#define MOCKGIOSSERVER_H
+
+#include <QTcpServer>
+#include <QHash>
+#include <QRandomGenerator>
+#include <QUrl>
+
+class QTcpSocket;
+
+/**
+ * @class MockGiosServer
+ * @brief Lokalny serwer HTTP udający API GIOŚ do testów end-to-end i pomiarów przepustowości.
+ *
+ * Obsługuje GET station/findAll, station/sensors/<id> i data/getData/<id> (HTTP/1.1,
+ * keep-alive), z konfigurowalnym opóźnieniem, rozrzutem opóźnienia, odsetkiem błędów 503
+ * i rozmiarem serii. Odpowiedzi mają nagłówek ETag; żądanie warunkowe (If-None-Match)
+ * o niezmienioną treść dostaje 304 Not Modified. Odpowiedzi są generowane deterministycznie albo czytane z katalogu
+ * utworzonego przez generate_dataset. Działa w pętli zdarzeń wątku, w którym powstał.
+ */
+class MockGiosServer : public QTcpServer
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Tworzy serwer; nasłuchiwanie zaczyna start().
+     * @param parent Rodzic obiektu.
+     */
+    explicit MockGiosServer(QObject *parent = nullptr);
+
+    /**
+     * @brief Zaczyna nasłuchiwać na 127.0.0.1.
+     * @param port Port (0 = wolny port wybrany przez system).
+     * @return true, jeśli serwer nasłuchuje.
+     */
+    bool start(quint16 port = 0);
+
+    /**
+     * @brief Adres bazowy do przekazania ApiWorker::setBaseUrl().
+     */
+    QUrl baseUrl() const;
+
+    void setLatency(int ms) { latencyMs = ms; }                /**< Stałe opóźnienie odpowiedzi (ms). */
+    void setJitter(int ms) { jitterMs = ms; }                  /**< Losowy dodatek do opóźnienia, 0..ms. */
+    void setErrorRate(double rate) { errorRate = rate; }       /**< Odsetek odpowiedzi 503 (0-1). */
+    void setStationCount(int count) { stationCount = count; }  /**< Liczba stacji w findAll. */
+    void setSensorsPerStation(int count) { sensorsPerStation = count; } /**< Sensory na stację. */
+    void setDataPoints(int count) { dataPoints = count; }      /**< Liczba pomiarów godzinowych w getData. */
+    void setDatasetDirectory(const QString &dir) { datasetDir = dir; } /**< Katalog z generate_dataset. */
+
+    int requestCount() const { return requests; }              /**< Liczba obsłużonych żądań. */
+    int maxConcurrentRequests() const { return maxInFlight; }  /**< Największa liczba żądań naraz. */
+    int notModifiedCount() const { return notModified; }        /**< Liczba odpowiedzi 304. */
+    qint64 bytesSent() const { return sentBytes; }             /**< Bajty ciał odpowiedzi. */
+
+private slots:
+    /**
+     * @brief Przyjmuje nowe połączenia.
+     */
+    void onNewConnection();
+
+    /**
+     * @brief Czyta żądania z połączenia (kolejne żądania keep-alive w tym samym buforze).
+     */
+    void onReadyRead();
+
+private:
+    /**
+     * @brief Wysyła odpowiedź na żądanie po skonfigurowanym opóźnieniu.
+     * @param socket Połączenie klienta.
+     * @param path Ścieżka z linii żądania.
+     * @param ifNoneMatch Wartość nagłówka If-None-Match (pusta, jeśli żądanie nie jest warunkowe).
+     */
+    void respond(QTcpSocket *socket, const QString &path, const QByteArray &ifNoneMatch);
+
+    /**
+     * @brief Buduje ciało odpowiedzi dla ścieżki.
+     * @param path Ścieżka względem /pjp-api/rest/.
+     * @param body Treść odpowiedzi.
+     * @return false dla nieznanej ścieżki (404).
+     */
+    bool buildBody(const QString &path, QByteArray &body) const;
+
+    QByteArray stationsJson() const;            /**< Generowana odpowiedź station/findAll. */
+    QByteArray sensorsJson(int stationId) const; /**< Generowana odpowiedź station/sensors/<id>. */
+    QByteArray dataJson(int sensorId) const;     /**< Generowana odpowiedź data/getData/<id>. */
+
+    QHash<QTcpSocket *, QByteArray> buffers; /**< Nieprzetworzone bajty z każdego połączenia. */
+    QRandomGenerator rng;                    /**< Losowanie opóźnień i błędów. */
+    QString datasetDir;                      /**< Katalog z danymi zamiast generowania. */
+    int latencyMs = 0;                       /**< Stałe opóźnienie odpowiedzi (ms). */
+    int jitterMs = 0;                        /**< Maksymalny losowy dodatek do opóźnienia (ms). */
+    double errorRate = 0.0;                  /**< Odsetek odpowiedzi 503. */
+    int stationCount = 50;                   /**< Liczba generowanych stacji. */
+    int sensorsPerStation = 3;               /**< Liczba sensorów na stację. */
+    int dataPoints = 72;                     /**< Liczba pomiarów w getData. */
+    int requests = 0;                        /**< Licznik żądań. */
+    int inFlight = 0;                        /**< Żądania czekające na odpowiedź. */
+    int maxInFlight = 0;                     /**< Maksimum inFlight. */
+    int notModified = 0;                     /**< Licznik odpowiedzi 304. */
+    qint64 sentBytes = 0;                    /**< Wysłane bajty ciał odpowiedzi. */
+};
+
+#endif // MOCKGIOSSERVER_H
@@ -0,0 +1,125 @@
+#include "requestscheduler.h"
+#include <QDateTime>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+void TokenBucket::refill(qint64 nowMs) {
+    if (lastRefillMs >= 0 && nowMs > lastRefillMs)
+        tokens = std::min(burst, tokens + (nowMs - lastRefillMs) * rate / 1000.0);
+    lastRefillMs = nowMs;
+}
+
+bool TokenBucket::tryTake(qint64 nowMs) {
+    refill(nowMs);
+    if (tokens < 1.0)
+        return false;
+    tokens -= 1.0;
+    return true;
+}
+
+qint64 TokenBucket::msUntilToken(qint64 nowMs) {
+    refill(nowMs);
+    if (tokens >= 1.0)
+        return 0;
+    return qint64(std::ceil((1.0 - tokens) * 1000.0 / rate));
+}
+
+RequestScheduler::RequestScheduler(QObject *parent)
+    : QObject(parent)
+{
+    setRateLimit(StationsClass, 1.0, 2);
+    setRateLimit(SensorsClass, 5.0, 10);
+    setRateLimit(DataClass, 5.0, 10);
+
+    timer.setSingleShot(true);
+    connect(&timer, &QTimer::timeout, this, &RequestScheduler::pump);
+}
+
+void RequestScheduler::setRateLimit(EndpointClass endpointClass, double ratePerSecond, int burst) {
+    TokenBucket &bucket = buckets[endpointClass];
+    bucket.rate = std::max(ratePerSecond, 0.001);
+    bucket.burst = std::max(burst, 1);
+    // Nieużywany kubełek startuje pełny
+    bucket.tokens = bucket.lastRefillMs < 0 ? bucket.burst : std::min(bucket.tokens, bucket.burst);
+}
+
+void RequestScheduler::setMaxConcurrent(Priority priority, int maxConcurrent) {
+    this->maxConcurrent[priority] = std::max(maxConcurrent, 1);
+    pump();
+}
+
+void RequestScheduler::enqueue(EndpointClass endpointClass, Priority priority, Dispatch dispatch) {
+    queues[priority][endpointClass].enqueue(std::move(dispatch));
+    pump();
+}
+
+void RequestScheduler::release(Priority priority) {
+    if (active[priority] > 0)
+        --active[priority];
+    pump();
+}
+
+int RequestScheduler::queueDepth() const {
+    int depth = 0;
+    for (int p = 0; p < PriorityCount; ++p)
+        depth += queueDepth(Priority(p));
+    return depth;
+}
+
+int RequestScheduler::queueDepth(EndpointClass endpointClass) const {
+    int depth = 0;
+    for (int p = 0; p < PriorityCount; ++p)
+        depth += queues[p][endpointClass].size();
+    return depth;
+}
+
+int RequestScheduler::queueDepth(Priority priority) const {
+    int depth = 0;
+    for (const auto &queue : queues[priority])
+        depth += queue.size();
+    return depth;
+}
+
+int RequestScheduler::activeCount(Priority priority) const {
+    return active[priority];
+}
+
+void RequestScheduler::pump() {
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    qint64 wait = std::numeric_limits<qint64>::max();
+
+    for (int c = 0; c < ClassCount; ++c) {
+        for (;;) {
+            // Najwyższy priorytet z czekającym żądaniem i wolnym połączeniem
+            int p = 0;
+            while (p < PriorityCount && (queues[p][c].isEmpty() || active[p] >= maxConcurrent[p]))
+                ++p;
+            if (p == PriorityCount)
+                break;
+
+            const qint64 untilToken = buckets[c].msUntilToken(now);
+            if (untilToken > 0) {
+                wait = std::min(wait, untilToken);
+                break;
+            }
+
+            // dispatch może zakolejkować kolejne żądanie - najpierw zdejmujemy
+            Dispatch dispatch = queues[p][c].dequeue();
+            if (dispatch()) {
+                buckets[c].tryTake(now);
+                ++active[p];
+            }
+        }
+    }
+
+    // Czekające żądania bez wolnego połączenia wybudzi release()
+    if (wait != std::numeric_limits<qint64>::max())
+        timer.start(int(std::max<qint64>(wait, 1)));
+
+    const int depth = queueDepth();
+    if (depth != reportedDepth) {
+        reportedDepth = depth;
+        emit queueDepthChanged(depth);
+    }
+}
@@ -0,0 +1,160 @@
+#ifndef REQUESTSCHEDULER_H
+#define REQUESTSCHEDULER_H
+
+#include <QObject>
+#include <QQueue>
+#include <QTimer>
+#include <functional>
+
+/**
+ * @struct TokenBucket
+ * @brief Kubełek żetonów: średnio rate żądań na sekundę, chwilowo do burst naraz.
+ */
+struct TokenBucket {
+    double rate = 5.0;        /**< Przyrost żetonów na sekundę. */
+    double burst = 10.0;      /**< Pojemność kubełka. */
+    double tokens = 10.0;     /**< Dostępne żetony. */
+    qint64 lastRefillMs = -1; /**< Czas ostatniego uzupełnienia (-1 = jeszcze nie). */
+
+    /**
+     * @brief Uzupełnia żetony za czas, który upłynął.
+     * @param nowMs Bieżący czas w ms.
+     */
+    void refill(qint64 nowMs);
+
+    /**
+     * @brief Pobiera żeton, jeśli jest dostępny.
+     * @param nowMs Bieżący czas w ms.
+     */
+    bool tryTake(qint64 nowMs);
+
+    /**
+     * @brief Czas w ms do pojawienia się następnego żetonu (0, jeśli jest dostępny).
+     * @param nowMs Bieżący czas w ms.
+     */
+    qint64 msUntilToken(qint64 nowMs);
+};
+
+/**
+ * @class RequestScheduler
+ * @brief Harmonogram wychodzących żądań API: limit tempa na klasę endpointu i priorytety.
+ *
+ * Żądanie dostaje żeton swojej klasy endpointu i jest wysyłane od razu albo czeka w kolejce
+ * FIFO, aż żeton się pojawi. Dzięki temu masowe odświeżanie wykorzystuje dozwolone tempo
+ * API, ale go nie przekracza. Żądania interaktywne (wybór stacji, przycisk pobierania) są
+ * obsługiwane przed zakolejkowanymi żądaniami w tle, a każdy priorytet ma własny limit
+ * równoczesnych połączeń - praca w tle nie zajmuje wszystkich połączeń do API. Suma
+ * limitów nie przekracza 6 połączeń QNetworkAccessManager do hosta, więc żądanie
+ * interaktywne nie czeka w wewnętrznej kolejce QNAM za żądaniami w tle.
+ * Głębokość kolejek jest dostępna do monitorowania.
+ */
+class RequestScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Klasy endpointów z osobnymi limitami tempa.
+     */
+    enum EndpointClass {
+        StationsClass = 0, /**< station/findAll. */
+        SensorsClass,      /**< station/sensors/<id>. */
+        DataClass,         /**< data/getData/<id>. */
+        ClassCount
+    };
+
+    /**
+     * @brief Priorytety żądań.
+     */
+    enum Priority {
+        Interactive = 0, /**< Żądanie, na które czeka użytkownik. */
+        Background,      /**< Prefetch i synchronizacja archiwum. */
+        PriorityCount
+    };
+
+    /**
+     * @brief Funkcja wysyłająca żądanie; zwraca false, jeśli żądanie jest już nieaktualne.
+     */
+    using Dispatch = std::function<bool()>;
+
+    /**
+     * @brief Tworzy harmonogram z domyślnymi limitami (lista stacji 1/s, pozostałe 5/s, burst 10;
+     *        4 połączenia interaktywne i 2 w tle - razem tyle, ile QNetworkAccessManager
+     *        otwiera do jednego hosta).
+     * @param parent Rodzic obiektu.
+     */
+    explicit RequestScheduler(QObject *parent = nullptr);
+
+    /**
+     * @brief Ustawia limit tempa klasy endpointu.
+     * @param endpointClass Klasa endpointu.
+     * @param ratePerSecond Średnia liczba żądań na sekundę.
+     * @param burst Liczba żądań, które mogą pójść naraz po okresie bezczynności.
+     */
+    void setRateLimit(EndpointClass endpointClass, double ratePerSecond, int burst);
+
+    /**
+     * @brief Ustawia limit równoczesnych połączeń priorytetu.
+     * @param priority Priorytet.
+     * @param maxConcurrent Największa liczba żądań priorytetu w locie.
+     */
+    void setMaxConcurrent(Priority priority, int maxConcurrent);
+
+    /**
+     * @brief Kolejkuje żądanie i wysyła je, gdy jest żeton klasy i wolne połączenie priorytetu.
+     *
+     * Po zakończeniu wysłanego żądania trzeba wywołać release().
+     * @param endpointClass Klasa endpointu.
+     * @param priority Priorytet żądania.
+     * @param dispatch Funkcja wysyłająca żądanie.
+     */
+    void enqueue(EndpointClass endpointClass, Priority priority, Dispatch dispatch);
+
+    /**
+     * @brief Zwalnia połączenie zakończonego żądania i wysyła kolejne z kolejki.
+     * @param priority Priorytet zakończonego żądania.
+     */
+    void release(Priority priority);
+
+    /**
+     * @brief Łączna liczba żądań czekających na wysłanie.
+     */
+    int queueDepth() const;
+
+    /**
+     * @brief Liczba żądań klasy czekających na wysłanie.
+     */
+    int queueDepth(EndpointClass endpointClass) const;
+
+    /**
+     * @brief Liczba żądań priorytetu czekających na wysłanie.
+     */
+    int queueDepth(Priority priority) const;
+
+    /**
+     * @brief Liczba wysłanych, jeszcze niezakończonych żądań priorytetu.
+     */
+    int activeCount(Priority priority) const;
+
+signals:
+    /**
+     * @brief Sygnał emitowany przy zmianie łącznej głębokości kolejek.
+     * @param depth Liczba żądań czekających na wysłanie.
+     */
+    void queueDepthChanged(int depth);
+
+private:
+    /**
+     * @brief Wysyła zakolejkowane żądania, na które są żetony i połączenia, i planuje następne wybudzenie.
+     */
+    void pump();
+
+    TokenBucket buckets[ClassCount];                       /**< Kubełek każdej klasy. */
+    QQueue<Dispatch> queues[PriorityCount][ClassCount];    /**< Kolejka każdego priorytetu i klasy. */
+    int maxConcurrent[PriorityCount] = {4, 2};             /**< Limit połączeń każdego priorytetu. */
+    int active[PriorityCount] = {};                        /**< Żądania w locie każdego priorytetu. */
+    int reportedDepth = 0;                                 /**< Ostatnio zgłoszona głębokość kolejek. */
+    QTimer timer{this};                                    /**< Wybudzenie, gdy pojawi się żeton (dziecko - wędruje z moveToThread). */
+};
+
+#endif // REQUESTSCHEDULER_H
@@ -0,0 +1,65 @@
+#include "retrypolicy.h"
+#include <algorithm>
+
+int RetryPolicy::backoffDelay(int attempt, QRandomGenerator &random) const {
+    const qint64 exponential = qint64(baseDelayMs) << std::min(attempt - 1, 20);
+    const int delay = int(std::min<qint64>(exponential, maxDelayMs));
+    return delay / 2 + int(random.bounded(delay / 2 + 1));
+}
+
+bool RetryPolicy::isRetryable(QNetworkReply::NetworkError error, int httpStatus) {
+    if (httpStatus == 429 || httpStatus >= 500)
+        return true;
+
+    switch (error) {
+    case QNetworkReply::ConnectionRefusedError:
+    case QNetworkReply::RemoteHostClosedError:
+    case QNetworkReply::TimeoutError:
+    case QNetworkReply::TemporaryNetworkFailureError:
+    case QNetworkReply::NetworkSessionFailedError:
+    case QNetworkReply::ProxyTimeoutError:
+    case QNetworkReply::UnknownNetworkError:
+    case QNetworkReply::ServiceUnavailableError:
+    case QNetworkReply::InternalServerError:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void CircuitBreaker::setPolicy(const RetryPolicy &policy) {
+    failureThreshold = policy.failureThreshold;
+    openDurationMs = policy.openDurationMs;
+}
+
+bool CircuitBreaker::allowRequest(const QString &host, qint64 nowMs) {
+    auto it = states.find(host);
+    if (it == states.end() || it->openUntilMs == 0)
+        return true;
+    if (nowMs < it->openUntilMs)
+        return false;
+
+    // Czas otwarcia minął - przepuszczamy jedno żądanie próbne, a kolejne dopiero po
+    // następnym okresie (gdyby próba została przerwana i nie dała wyniku)
+    it->probing = true;
+    it->openUntilMs = nowMs + openDurationMs;
+    return true;
+}
+
+void CircuitBreaker::recordSuccess(const QString &host) {
+    states.remove(host);
+}
+
+void CircuitBreaker::recordFailure(const QString &host, qint64 nowMs) {
+    State &state = states[host];
+    ++state.failures;
+    if (state.probing || state.failures >= failureThreshold) {
+        state.openUntilMs = nowMs + openDurationMs;
+        state.probing = false;
+    }
+}
+
+bool CircuitBreaker::isOpen(const QString &host, qint64 nowMs) const {
+    auto it = states.constFind(host);
+    return it != states.constEnd() && nowMs < it->openUntilMs;
+}
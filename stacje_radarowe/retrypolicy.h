@@ -0,0 +1,92 @@
+#ifndef RETRYPOLICY_H
+#define RETRYPOLICY_H
+
+#include <QHash>
+#include <QNetworkReply>
+#include <QRandomGenerator>
+#include <QString>
+
+/**
+ * @struct RetryPolicy
+ * @brief Parametry ponawiania żądań i wyłącznika obwodu (circuit breaker).
+ *
+ * Błąd przejściowy (sieć, HTTP 5xx, 429) jest ponawiany do maxAttempts prób z wykładniczo
+ * rosnącym opóźnieniem i losowym rozrzutem, żeby wielu klientów nie ponawiało naraz.
+ * Po failureThreshold kolejnych błędach hosta obwód otwiera się na openDurationMs.
+ */
+struct RetryPolicy {
+    int maxAttempts = 3;          /**< Łączna liczba prób (1 = bez ponawiania). */
+    int baseDelayMs = 500;        /**< Opóźnienie przed drugą próbą. */
+    int maxDelayMs = 8000;        /**< Górne ograniczenie opóźnienia. */
+    int failureThreshold = 5;     /**< Kolejne błędy hosta otwierające obwód. */
+    int openDurationMs = 30000;   /**< Czas otwarcia obwodu. */
+
+    /**
+     * @brief Opóźnienie przed kolejną próbą: połowa wykładniczego opóźnienia plus losowa reszta.
+     * @param attempt Numer nieudanej próby (od 1).
+     * @param random Generator liczb losowych.
+     */
+    int backoffDelay(int attempt, QRandomGenerator &random) const;
+
+    /**
+     * @brief Sprawdza, czy błąd jest przejściowy i warto ponowić żądanie.
+     * @param error Kod błędu odpowiedzi.
+     * @param httpStatus Kod statusu HTTP (0, jeśli brak).
+     */
+    static bool isRetryable(QNetworkReply::NetworkError error, int httpStatus);
+};
+
+/**
+ * @class CircuitBreaker
+ * @brief Wyłącznik obwodu dla każdego hosta osobno.
+ *
+ * Zamknięty: żądania idą do sieci. Otwarty: żądania są od razu kierowane do cache/offline.
+ * Po upływie czasu otwarcia przepuszczane jest jedno żądanie próbne (półotwarty); jego
+ * sukces zamyka obwód, a błąd otwiera go ponownie. Czas podawany jest jawnie (ms).
+ */
+class CircuitBreaker {
+public:
+    /**
+     * @brief Ustawia próg błędów i czas otwarcia.
+     * @param policy Polityka z failureThreshold i openDurationMs.
+     */
+    void setPolicy(const RetryPolicy &policy);
+
+    /**
+     * @brief Sprawdza, czy żądanie do hosta może iść do sieci (także jako próba w stanie półotwartym).
+     * @param host Nazwa hosta.
+     * @param nowMs Bieżący czas w ms.
+     */
+    bool allowRequest(const QString &host, qint64 nowMs);
+
+    /**
+     * @brief Zapisuje udane żądanie - zamyka obwód.
+     */
+    void recordSuccess(const QString &host);
+
+    /**
+     * @brief Zapisuje błąd przejściowy - po przekroczeniu progu otwiera obwód.
+     */
+    void recordFailure(const QString &host, qint64 nowMs);
+
+    /**
+     * @brief Sprawdza, czy obwód hosta jest otwarty.
+     */
+    bool isOpen(const QString &host, qint64 nowMs) const;
+
+private:
+    /**
+     * @brief Stan obwodu jednego hosta.
+     */
+    struct State {
+        int failures = 0;         /**< Kolejne błędy. */
+        qint64 openUntilMs = 0;   /**< Koniec otwarcia obwodu (0 = zamknięty). */
+        bool probing = false;     /**< Czy trwa żądanie próbne. */
+    };
+
+    QHash<QString, State> states; /**< Stan obwodu według hosta. */
+    int failureThreshold = 5;     /**< Próg błędów. */
+    int openDurationMs = 30000;   /**< Czas otwarcia. */
+};
+
+#endif // RETRYPOLICY_H
@@ -0,0 +1,359 @@
+#include "seriesfile.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+const char kMagic[4] = {'G', 'S', 'E', 'R'};
+const quint16 kVersion = 2;
+
+struct Header {
+    char magic[4];
+    quint16 version;
+    quint16 keyLength;
+    qint32 sensorId;
+    quint32 count;
+};
+static_assert(sizeof(Header) == 16, "SeriesFile header must be 16 bytes");
+
+struct BlockHeader {
+    quint32 count;
+    quint32 reserved;
+};
+static_assert(sizeof(BlockHeader) == 8, "SeriesFile block header must be 8 bytes");
+
+const qint64 kCountOffset = offsetof(Header, count);
+
+qint64 align8(qint64 offset) {
+    return (offset + 7) & ~qint64(7);
+}
+
+// Przesunięcia kolumn względem początku bloku dla danej liczby punktów
+struct BlockLayout {
+    qint64 timestamps;
+    qint64 values;
+    qint64 nulls;
+    qint64 total;
+
+    explicit BlockLayout(quint32 count) {
+        timestamps = sizeof(BlockHeader);
+        values = timestamps + qint64(count) * qint64(sizeof(qint64));
+        nulls = values + qint64(count) * qint64(sizeof(float));
+        total = align8(nulls + (qint64(count) + 7) / 8);
+    }
+};
+
+QByteArray encodeBlock(const MeasurementSeries &series) {
+    const quint32 count = quint32(series.size());
+    const BlockLayout layout(count);
+    QByteArray buffer(layout.total, '\0');
+    char *out = buffer.data();
+
+    BlockHeader header = {count, 0};
+    std::memcpy(out, &header, sizeof(header));
+
+    qint64 *timestamps = reinterpret_cast<qint64 *>(out + layout.timestamps);
+    float *values = reinterpret_cast<float *>(out + layout.values);
+    uchar *nulls = reinterpret_cast<uchar *>(out + layout.nulls);
+    for (quint32 i = 0; i < count; ++i) {
+        timestamps[i] = series.timestamps[i] / 1000;
+        if (series.isNull(i)) {
+            nulls[i / 8] |= uchar(1u << (i % 8));
+        } else {
+            values[i] = float(series.values[i]);
+        }
+    }
+    return buffer;
+}
+
+} // namespace
+
+SeriesFile::~SeriesFile() {
+    close();
+}
+
+QString SeriesFile::offlinePath(int sensorId) {
+    return "offline/dane_" + QString::number(sensorId) + ".bin";
+}
+
+bool SeriesFile::write(const QString &path, const MeasurementSeries &series) {
+    const QByteArray key = series.key.toUtf8().left(0xFFFF);
+
+    Header header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.keyLength = quint16(key.size());
+    header.sensorId = series.sensorId;
+    header.count = quint32(series.size());
+
+    QByteArray buffer(align8(qint64(sizeof(Header)) + key.size()), '\0');
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    std::memcpy(buffer.data() + sizeof(header), key.constData(), key.size());
+    if (series.size() > 0)
+        buffer += encodeBlock(series);
+
+    QDir().mkpath(QFileInfo(path).path());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    file.write(buffer);
+    return file.commit();
+}
+
+bool SeriesFile::appendBlock(const QString &path, qint64 blocksEnd, const MeasurementSeries &series) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadWrite)) return false;
+
+    Header header;
+    if (file.read(reinterpret_cast<char *>(&header), sizeof(header)) != qint64(sizeof(header)))
+        return false;
+
+    // Najpierw blok, potem licznik - przerwany zapis zostawia plik czytelny
+    // (czytnik ignoruje bloki ponad licznik z nagłówka). Blok osierocony przez taki
+    // zapis obcinamy, żeby nowy blok stanął zaraz za blokami objętymi licznikiem.
+    const QByteArray block = encodeBlock(series);
+    if (file.size() > blocksEnd && !file.resize(blocksEnd))
+        return false;
+    if (!file.seek(blocksEnd) || file.write(block) != block.size())
+        return false;
+    if (!file.flush())
+        return false;
+
+    const quint32 count = header.count + quint32(series.size());
+    if (!file.seek(kCountOffset))
+        return false;
+    return file.write(reinterpret_cast<const char *>(&count), sizeof(count)) == qint64(sizeof(count));
+}
+
+bool SeriesFile::merge(const QString &path, const MeasurementSeries &series) {
+    if (!QFile::exists(path))
+        return write(path, series);
+
+    // Nieczytelnego archiwum (uszkodzony nagłówek, inna wersja, inny sensor) nie nadpisujemy
+    // bieżącym oknem API - odkładamy je obok i zaczynamy nowe
+    SeriesFile existing;
+    if (!existing.open(path) || existing.sensorId() != series.sensorId) {
+        existing.close();
+        // Każde odłożenie dostaje własną nazwę - wcześniej odłożone archiwum zostaje nietknięte
+        const QString stamp = QDateTime::currentDateTimeUtc().toString("yyyyMMdd-HHmmss");
+        QString aside = path + ".corrupt-" + stamp;
+        for (int n = 2; QFile::exists(aside); ++n)
+            aside = path + ".corrupt-" + stamp + "-" + QString::number(n);
+        if (!QFile::rename(path, aside))
+            return false;
+        return write(path, series);
+    }
+
+    const int storedCount = existing.count();
+    const qint64 lastStored = storedCount > 0 ? existing.timestampAt(storedCount - 1)
+                                              : std::numeric_limits<qint64>::min();
+
+    MeasurementSeries tail;
+    tail.sensorId = series.sensorId;
+    tail.key = series.key;
+    bool overlapChanged = false;
+
+    for (int i = 0; i < series.size(); ++i) {
+        const qint64 seconds = series.timestamps[i] / 1000;
+        if (seconds > lastStored) {
+            // Powtórzony znacznik w świeżych danych - zostaje ostatnia wartość
+            if (!tail.timestamps.isEmpty() && tail.timestamps.last() / 1000 == seconds) {
+                tail.values.last() = series.values[i];
+                continue;
+            }
+            tail.timestamps.append(series.timestamps[i]);
+            tail.values.append(series.values[i]);
+            continue;
+        }
+        if (series.isNull(i)) continue;
+
+        // Punkt już w archiwum: sprawdzamy, czy API nie zmieniło (np. uzupełniło) wartości
+        int lo = 0, hi = storedCount;
+        while (lo < hi) {
+            const int mid = lo + (hi - lo) / 2;
+            if (existing.timestampAt(mid) < seconds) lo = mid + 1;
+            else hi = mid;
+        }
+        if (lo == storedCount || existing.timestampAt(lo) != seconds || existing.isNullAt(lo)
+            || existing.valueAt(lo) != float(series.values[i])) {
+            overlapChanged = true;
+            break;
+        }
+    }
+
+    if (overlapChanged) {
+        MeasurementSeries merged = mergeSeries(existing.toSeries(), series);
+        existing.close();
+        return write(path, merged);
+    }
+
+    const qint64 blocksEnd = existing.dataEnd;
+    existing.close();
+    if (tail.timestamps.isEmpty()) return true;
+    return appendBlock(path, blocksEnd, tail);
+}
+
+MeasurementSeries SeriesFile::mergeSeries(const MeasurementSeries &stored, const MeasurementSeries &fresh) {
+    MeasurementSeries merged;
+    merged.sensorId = fresh.sensorId;
+    merged.key = fresh.key.isEmpty() ? stored.key : fresh.key;
+    merged.timestamps.reserve(stored.size() + fresh.size());
+    merged.values.reserve(stored.size() + fresh.size());
+
+    auto appendPoint = [&merged](qint64 timestamp, double value) {
+        if (!merged.timestamps.isEmpty() && merged.timestamps.last() == timestamp) {
+            if (!std::isnan(value)) merged.values.last() = value;
+            return;
+        }
+        merged.timestamps.append(timestamp);
+        merged.values.append(value);
+    };
+
+    int i = 0, j = 0;
+    while (i < stored.size() || j < fresh.size()) {
+        // Przy równych znacznikach najpierw archiwum, potem świeży punkt, który je nadpisze
+        if (j == fresh.size() || (i < stored.size() && stored.timestamps[i] <= fresh.timestamps[j])) {
+            appendPoint(stored.timestamps[i], stored.values[i]);
+            ++i;
+        } else {
+            appendPoint(fresh.timestamps[j], fresh.values[j]);
+            ++j;
+        }
+    }
+    return merged;
+}
+
+bool SeriesFile::open(const QString &path) {
+    close();
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    const qint64 size = file.size();
+    if (size < qint64(sizeof(Header))) {
+        close();
+        return false;
+    }
+
+    data = file.map(0, size);
+    if (!data) {
+        close();
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+        close();
+        return false;
+    }
+
+    // Przejście po blokach buduje tylko tablicę wskaźników - dane zostają w mapowaniu
+    qint64 offset = align8(qint64(sizeof(Header)) + header.keyLength);
+    quint32 total = 0;
+    while (total < header.count) {
+        if (offset + qint64(sizeof(BlockHeader)) > size) {
+            close();
+            return false;
+        }
+        BlockHeader blockHeader;
+        std::memcpy(&blockHeader, data + offset, sizeof(blockHeader));
+        const BlockLayout layout(blockHeader.count);
+        if (offset + layout.total > size || blockHeader.count > header.count - total) {
+            close();
+            return false;
+        }
+
+        Block block;
+        block.first = int(total);
+        block.count = int(blockHeader.count);
+        block.timestamps = reinterpret_cast<const qint64 *>(data + offset + layout.timestamps);
+        block.values = reinterpret_cast<const float *>(data + offset + layout.values);
+        block.nulls = data + offset + layout.nulls;
+        blocks.append(block);
+
+        total += blockHeader.count;
+        offset += layout.total;
+    }
+
+    pointCount = int(total);
+    dataEnd = offset;
+    return true;
+}
+
+void SeriesFile::close() {
+    if (data)
+        file.unmap(const_cast<uchar *>(data));
+    file.close();
+    data = nullptr;
+    blocks.clear();
+    pointCount = 0;
+    dataEnd = 0;
+}
+
+bool SeriesFile::isOpen() const {
+    return data != nullptr;
+}
+
+int SeriesFile::sensorId() const {
+    return reinterpret_cast<const Header *>(data)->sensorId;
+}
+
+QString SeriesFile::key() const {
+    const Header *header = reinterpret_cast<const Header *>(data);
+    return QString::fromUtf8(reinterpret_cast<const char *>(data + sizeof(Header)), header->keyLength);
+}
+
+int SeriesFile::count() const {
+    return pointCount;
+}
+
+int SeriesFile::blockCount() const {
+    return blocks.size();
+}
+
+const SeriesFile::Block &SeriesFile::blockFor(int &index) const {
+    auto it = std::upper_bound(blocks.cbegin(), blocks.cend(), index,
+                               [](int value, const Block &block) { return value < block.first; });
+    const Block &block = *(it - 1);
+    index -= block.first;
+    return block;
+}
+
+qint64 SeriesFile::timestampAt(int index) const {
+    const Block &block = blockFor(index);
+    return block.timestamps[index];
+}
+
+float SeriesFile::valueAt(int index) const {
+    const Block &block = blockFor(index);
+    return block.values[index];
+}
+
+bool SeriesFile::isNullAt(int index) const {
+    const Block &block = blockFor(index);
+    return block.nulls[index / 8] & (1u << (index % 8));
+}
+
+MeasurementSeries SeriesFile::toSeries() const {
+    MeasurementSeries series;
+    if (!isOpen()) return series;
+
+    series.sensorId = sensorId();
+    series.key = key();
+    series.timestamps.reserve(pointCount);
+    series.values.reserve(pointCount);
+    for (const Block &block : blocks) {
+        for (int i = 0; i < block.count; ++i) {
+            const bool isNull = block.nulls[i / 8] & (1u << (i % 8));
+            series.timestamps.append(block.timestamps[i] * 1000);
+            series.values.append(isNull ? std::numeric_limits<double>::quiet_NaN() : double(block.values[i]));
+        }
+    }
+    return series;
+}
@@ -0,0 +1,165 @@
+#ifndef SERIESFILE_H
+#define SERIESFILE_H
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include "measurementseries.h"
+
+/**
+ * @class SeriesFile
+ * @brief Binarny, kolumnowy plik offline z archiwum serii pomiarowej jednego sensora.
+ *
+ * Układ pliku (little-endian):
+ * - nagłówek 16 B: magic "GSER", wersja (u16), długość klucza (u16), ID sensora (i32),
+ *   łączna liczba punktów (u32),
+ * - klucz parametru w UTF-8, dopełniony do wielokrotności 8 bajtów,
+ * - bloki danych, każdy: liczba punktów (u32) + 4 B rezerwy, kolumna znaczników czasu
+ *   (int64, sekundy od epoki), kolumna wartości (float32), mapa braków danych
+ *   (1 bit na punkt, 1 = brak wartości), dopełnienie do 8 bajtów.
+ *
+ * Punkty są rosnące po czasie w obrębie pliku. Nowe pomiary dopisywane są jako kolejny
+ * blok na końcu pliku, więc odświeżenie nie przepisuje archiwum. Odczyt mapuje plik do
+ * pamięci (QFile::map), więc wczytanie serii nie wymaga parsowania.
+ */
+class SeriesFile {
+public:
+    /**
+     * @brief Tworzy niepowiązany obiekt; użyj open(), aby zmapować plik.
+     */
+    SeriesFile() = default;
+    ~SeriesFile();
+
+    SeriesFile(const SeriesFile &) = delete;
+    SeriesFile &operator=(const SeriesFile &) = delete;
+
+    /**
+     * @brief Ścieżka pliku offline dla sensora.
+     * @param sensorId Identyfikator sensora.
+     */
+    static QString offlinePath(int sensorId);
+
+    /**
+     * @brief Zapisuje serię do nowego pliku (atomowo, przez QSaveFile).
+     * @param path Ścieżka pliku.
+     * @param series Seria posortowana rosnąco po czasie.
+     * @return true, jeśli zapis się powiódł.
+     */
+    static bool write(const QString &path, const MeasurementSeries &series);
+
+    /**
+     * @brief Dołącza świeżo pobraną serię do archiwum w pliku.
+     *
+     * Punkty nowsze niż ostatni zapisany są dopisywane jako nowy blok. Jeśli świeże dane
+     * zmieniają punkty już zapisane (np. uzupełniony brak pomiaru), archiwum jest scalane
+     * po znaczniku czasu i zapisywane od nowa. Brak pliku oznacza zwykły zapis; plik,
+     * którego nie da się odczytać (lub innego sensora), jest przenoszony do
+     * path + ".corrupt-<data UTC>" (z numerem, jeśli taki plik już istnieje).
+     * @param path Ścieżka pliku.
+     * @param series Świeża seria posortowana rosnąco po czasie.
+     * @return true, jeśli zapis się powiódł.
+     */
+    static bool merge(const QString &path, const MeasurementSeries &series);
+
+    /**
+     * @brief Scala dwie serie po znaczniku czasu; przy kolizji wygrywa niepusta wartość z fresh.
+     * @param stored Seria z archiwum.
+     * @param fresh Świeża seria.
+     * @return Seria rosnąca po czasie, bez powtórzonych znaczników.
+     */
+    static MeasurementSeries mergeSeries(const MeasurementSeries &stored, const MeasurementSeries &fresh);
+
+    /**
+     * @brief Otwiera i mapuje plik do pamięci, sprawdzając nagłówek i bloki.
+     * @param path Ścieżka pliku.
+     * @return true, jeśli plik ma poprawny format.
+     */
+    bool open(const QString &path);
+
+    /**
+     * @brief Zamyka mapowanie i plik.
+     */
+    void close();
+
+    /**
+     * @brief Sprawdza, czy plik jest otwarty i poprawny.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Identyfikator sensora zapisany w nagłówku.
+     */
+    int sensorId() const;
+
+    /**
+     * @brief Kod parametru zapisany w pliku.
+     */
+    QString key() const;
+
+    /**
+     * @brief Liczba punktów w pliku.
+     */
+    int count() const;
+
+    /**
+     * @brief Liczba bloków danych w pliku.
+     */
+    int blockCount() const;
+
+    /**
+     * @brief Znacznik czasu punktu w sekundach od epoki.
+     * @param index Indeks punktu.
+     */
+    qint64 timestampAt(int index) const;
+
+    /**
+     * @brief Wartość punktu (bez znaczenia, jeśli isNullAt() zwraca true).
+     * @param index Indeks punktu.
+     */
+    float valueAt(int index) const;
+
+    /**
+     * @brief Sprawdza, czy punkt nie ma wartości.
+     * @param index Indeks punktu.
+     */
+    bool isNullAt(int index) const;
+
+    /**
+     * @brief Kopiuje zawartość pliku do serii w pamięci.
+     */
+    MeasurementSeries toSeries() const;
+
+private:
+    /**
+     * @brief Widok jednego bloku w zmapowanym pliku.
+     */
+    struct Block {
+        int first = 0;                      /**< Indeks pierwszego punktu bloku w całym pliku. */
+        int count = 0;                      /**< Liczba punktów bloku. */
+        const qint64 *timestamps = nullptr; /**< Kolumna znaczników czasu. */
+        const float *values = nullptr;      /**< Kolumna wartości. */
+        const uchar *nulls = nullptr;       /**< Mapa bitowa braków danych. */
+    };
+
+    /**
+     * @brief Zwraca blok zawierający punkt i zamienia indeks na indeks w bloku.
+     * @param index Indeks punktu w pliku; na wyjściu indeks w bloku.
+     */
+    const Block &blockFor(int &index) const;
+
+    /**
+     * @brief Dopisuje blok za blokami objętymi licznikiem i aktualizuje licznik w nagłówku.
+     * @param path Ścieżka pliku.
+     * @param blocksEnd Koniec ostatniego bloku objętego licznikiem (dalsze bajty są obcinane).
+     * @param series Punkty nowego bloku.
+     */
+    static bool appendBlock(const QString &path, qint64 blocksEnd, const MeasurementSeries &series);
+
+    QFile file;            /**< Zmapowany plik. */
+    const uchar *data = nullptr; /**< Początek mapowania. */
+    QVector<Block> blocks; /**< Bloki danych w kolejności z pliku. */
+    int pointCount = 0;    /**< Łączna liczba punktów. */
+    qint64 dataEnd = 0;    /**< Koniec ostatniego bloku objętego licznikiem z nagłówka. */
+};
+
+#endif // SERIESFILE_H
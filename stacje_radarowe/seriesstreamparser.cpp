@@ -0,0 +1,154 @@
+#include "seriesstreamparser.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <limits>
+
+void SeriesStreamParser::feed(const QByteArray &chunk) {
+    if (failed) return;
+    buffer.append(chunk);
+    parse(false);
+}
+
+bool SeriesStreamParser::finish() {
+    if (!failed) {
+        parse(true);
+        if (!failed && !done)
+            fail("unexpected end of data");
+    }
+    return !failed;
+}
+
+MeasurementSeries SeriesStreamParser::takeSeries(int sensorId) {
+    const MeasurementSeries series = MeasurementSeries::fromPoints(sensorId, key, timestamps, values);
+    *this = SeriesStreamParser();
+    return series;
+}
+
+void SeriesStreamParser::fail(const QString &message) {
+    failed = true;
+    error = message;
+    buffer.clear();
+    pos = 0;
+}
+
+bool SeriesStreamParser::inPoint() const {
+    // {"values": [ {punkt}, ... ]}
+    return stack.size() == 3 && stack[0].key == "values" && !stack[1].isObject && stack[2].isObject;
+}
+
+void SeriesStreamParser::parse(bool atEnd) {
+    const char *data = buffer.constData();
+    const qsizetype size = buffer.size();
+
+    while (!failed) {
+        while (pos < size && (data[pos] == ' ' || data[pos] == '\n' || data[pos] == '\r' || data[pos] == '\t'))
+            ++pos;
+        if (pos >= size) break;
+
+        const char c = data[pos];
+        if (done) {
+            fail("garbage after JSON document");
+            return;
+        }
+        if (stack.isEmpty() && c != '{') {
+            fail("expected JSON object for data");
+            return;
+        }
+
+        if (c == '{' || c == '[') {
+            if (!stack.isEmpty() && stack.last().isObject && stack.last().expectKey) {
+                fail("expected object key");
+                return;
+            }
+            Frame frame;
+            frame.isObject = c == '{';
+            frame.expectKey = frame.isObject;
+            stack.append(frame);
+            if (inPoint()) {
+                pointHasDate = false;
+                pointValue = std::numeric_limits<double>::quiet_NaN();
+            }
+            ++pos;
+        } else if (c == '}' || c == ']') {
+            if (stack.last().isObject != (c == '}')) {
+                fail("mismatched bracket");
+                return;
+            }
+            if (c == '}' && inPoint() && pointHasDate) {
+                timestamps.append(pointTimestamp);
+                values.append(pointValue);
+            }
+            stack.removeLast();
+            done = stack.isEmpty();
+            ++pos;
+        } else if (c == ',') {
+            if (stack.last().isObject) {
+                stack.last().expectKey = true;
+                stack.last().key = QByteArray();
+            }
+            ++pos;
+        } else if (c == ':') {
+            ++pos;
+        } else if (c == '"') {
+            qsizetype end = pos + 1;
+            while (end < size && data[end] != '"')
+                end += data[end] == '\\' ? 2 : 1;
+            if (end >= size) break; // napis urwany na granicy porcji
+
+            Frame &top = stack.last();
+            if (top.isObject && top.expectKey) {
+                top.key = QByteArray(data + pos + 1, end - pos - 1);
+                top.expectKey = false;
+            } else {
+                value(data + pos + 1, end - pos - 1, true);
+            }
+            pos = end + 1;
+        } else {
+            qsizetype end = pos;
+            while (end < size && data[end] != ',' && data[end] != '}' && data[end] != ']'
+                   && data[end] != ' ' && data[end] != '\n' && data[end] != '\r' && data[end] != '\t')
+                ++end;
+            if (end >= size && !atEnd) break; // liczba może mieć dalszy ciąg w następnej porcji
+
+            value(data + pos, end - pos, false);
+            pos = end;
+        }
+    }
+
+    // Zostawiamy tylko nieprzetworzoną końcówkę
+    if (failed) return;
+    if (pos == buffer.size()) {
+        buffer.clear();
+        pos = 0;
+    } else if (pos > 4096 && pos * 2 > buffer.size()) {
+        buffer.remove(0, pos);
+        pos = 0;
+    }
+}
+
+void SeriesStreamParser::value(const char *text, qsizetype length, bool isString) {
+    const Frame &top = stack.last();
+    if (top.isObject && top.key.isNull()) {
+        fail("expected object key");
+        return;
+    }
+
+    if (stack.size() == 1 && top.key == "key" && isString) {
+        const QByteArray raw(text, length);
+        if (raw.contains('\\')) {
+            // Rzadki przypadek sekwencji ucieczki - dekodujemy sam napis
+            key = QJsonDocument::fromJson("[\"" + raw + "\"]").array().at(0).toString();
+        } else {
+            key = QString::fromUtf8(raw);
+        }
+    } else if (inPoint() && top.key == "date" && isString) {
+        pointHasDate = timestampParser.parse(text, length, pointTimestamp);
+        // Format inny niż "yyyy-MM-dd HH:mm:ss" - wolniejsza, ogólna ścieżka
+        if (!pointHasDate)
+            pointHasDate = TimestampParser::parseIso(QString::fromUtf8(text, length), pointTimestamp);
+    } else if (inPoint() && top.key == "value" && !isString) {
+        bool ok = false;
+        const double number = QByteArray::fromRawData(text, length).toDouble(&ok);
+        pointValue = ok ? number : std::numeric_limits<double>::quiet_NaN();
+    }
+}
@@ -0,0 +1,106 @@
+#ifndef SERIESSTREAMPARSER_H
+#define SERIESSTREAMPARSER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include "measurementseries.h"
+#include "timestampparser.h"
+
+/**
+ * @class SeriesStreamParser
+ * @brief Przyrostowy parser odpowiedzi data/getData karmiony kolejnymi porcjami bajtów.
+ *
+ * Zamiast buforować całą odpowiedź i budować drzewo QJsonDocument, parser przechodzi
+ * tokeny JSON w miarę napływu danych (QNetworkReply::readyRead) i od razu zapisuje
+ * pary (date, value) do kolumn serii. Daty są czytane wprost z bajtów odpowiedzi przez
+ * TimestampParser. W buforze zostaje tylko niedokończony ostatni token, więc pamięć
+ * nie rośnie z rozmiarem odpowiedzi, a parsowanie nakłada się na pobieranie.
+ */
+class SeriesStreamParser {
+public:
+    /**
+     * @brief Przetwarza kolejną porcję odpowiedzi.
+     * @param chunk Bajty odpowiedzi (dowolnie pocięte, także w środku tokenu).
+     */
+    void feed(const QByteArray &chunk);
+
+    /**
+     * @brief Kończy parsowanie po ostatniej porcji.
+     * @return true, jeśli odpowiedź była kompletnym, poprawnym obiektem JSON.
+     */
+    bool finish();
+
+    /**
+     * @brief Czy wystąpił błąd składni.
+     */
+    bool hasError() const { return failed; }
+
+    /**
+     * @brief Opis błędu składni.
+     */
+    QString errorString() const { return error; }
+
+    /**
+     * @brief Liczba punktów odczytanych do tej pory.
+     */
+    qsizetype pointCount() const { return timestamps.size(); }
+
+    /**
+     * @brief Zwraca odczytaną serię posortowaną rosnąco i zeruje stan parsera.
+     * @param sensorId Identyfikator sensora.
+     */
+    MeasurementSeries takeSeries(int sensorId = 0);
+
+private:
+    /**
+     * @brief Otwarty obiekt lub tablica JSON.
+     */
+    struct Frame {
+        bool isObject = false;  /**< Obiekt (true) albo tablica. */
+        bool expectKey = false; /**< Czy następny napis w obiekcie to klucz. */
+        QByteArray key;         /**< Klucz bieżącej wartości obiektu. */
+    };
+
+    /**
+     * @brief Przetwarza kompletne tokeny z bufora.
+     * @param atEnd Czy to koniec odpowiedzi (ostatni literał nie czeka na separator).
+     */
+    void parse(bool atEnd);
+
+    /**
+     * @brief Obsługuje napis lub literał (liczba, null, true, false) jako wartość.
+     * @param text Początek tokenu (napis bez cudzysłowów).
+     * @param length Długość tokenu.
+     * @param isString Czy token jest napisem.
+     */
+    void value(const char *text, qsizetype length, bool isString);
+
+    /**
+     * @brief Czy stos wskazuje na obiekt punktu w tablicy "values".
+     */
+    bool inPoint() const;
+
+    /**
+     * @brief Zapisuje błąd składni i przerywa dalsze parsowanie.
+     * @param message Opis błędu.
+     */
+    void fail(const QString &message);
+
+    QByteArray buffer;          /**< Nieprzetworzona końcówka odpowiedzi. */
+    qsizetype pos = 0;          /**< Pozycja pierwszego nieprzetworzonego bajtu w buforze. */
+    QVector<Frame> stack;       /**< Otwarte obiekty i tablice. */
+    bool done = false;          /**< Czy obiekt główny został zamknięty. */
+    bool failed = false;        /**< Czy wystąpił błąd składni. */
+    QString error;              /**< Opis błędu. */
+
+    QString key;                /**< Kod parametru ("key"). */
+    QVector<qint64> timestamps; /**< Znaczniki czasu w kolejności z API. */
+    QVector<double> values;     /**< Wartości w kolejności z API. */
+    bool pointHasDate = false;  /**< Czy bieżący punkt ma poprawną datę. */
+    qint64 pointTimestamp = 0;  /**< Data bieżącego punktu. */
+    double pointValue = 0.0;    /**< Wartość bieżącego punktu. */
+    TimestampParser timestampParser; /**< Parser dat z zapamiętanym przesunięciem strefy. */
+};
+
+#endif // SERIESSTREAMPARSER_H
@@ -0,0 +1,152 @@
+#include "spatialindex.h"
+#include <QtMath>
+#include <algorithm>
+
+static constexpr double kEarthRadiusKm = 6371.0088;
+
+static void toUnitVector(double lat, double lon, double *out) {
+    const double phi = qDegreesToRadians(lat);
+    const double lambda = qDegreesToRadians(lon);
+    out[0] = std::cos(phi) * std::cos(lambda);
+    out[1] = std::cos(phi) * std::sin(lambda);
+    out[2] = std::sin(phi);
+}
+
+static double squaredChord(const double *a, const double *b) {
+    const double dx = a[0] - b[0];
+    const double dy = a[1] - b[1];
+    const double dz = a[2] - b[2];
+    return dx * dx + dy * dy + dz * dz;
+}
+
+// Długość cięciwy sfery jednostkowej <-> odległość po okręgu wielkim
+static double chordToKm(double chord) {
+    return 2.0 * kEarthRadiusKm * std::asin(std::min(1.0, chord / 2.0));
+}
+
+static double kmToChord(double km) {
+    const double angle = std::min(km / kEarthRadiusKm, M_PI);
+    return 2.0 * std::sin(angle / 2.0);
+}
+
+SpatialIndex::SpatialIndex(const QVector<GeoPoint> &points) {
+    nodes.reserve(points.size());
+    for (const GeoPoint &point : points) {
+        Node node;
+        toUnitVector(point.lat, point.lon, node.p);
+        node.id = point.id;
+        nodes.append(node);
+    }
+    build(0, nodes.size(), 0);
+}
+
+void SpatialIndex::build(int begin, int end, int depth) {
+    if (end - begin <= 1) return;
+
+    const int axis = depth % 3;
+    const int mid = begin + (end - begin) / 2;
+    std::nth_element(nodes.begin() + begin, nodes.begin() + mid, nodes.begin() + end,
+                     [axis](const Node &a, const Node &b) { return a.p[axis] < b.p[axis]; });
+    build(begin, mid, depth + 1);
+    build(mid + 1, end, depth + 1);
+}
+
+QVector<GeoMatch> SpatialIndex::nearest(double lat, double lon, int count) const {
+    if (count <= 0 || nodes.isEmpty()) return {};
+
+    double q[3];
+    toUnitVector(lat, lon, q);
+
+    // Kopiec maksymalny (po kwadracie cięciwy) z najlepszymi dotąd kandydatami
+    QVector<QPair<double, int>> heap;
+    heap.reserve(count + 1);
+    searchNearest(0, nodes.size(), 0, q, count, heap);
+    return toMatches(heap);
+}
+
+QVector<GeoMatch> SpatialIndex::withinRadius(double lat, double lon, double radiusKm) const {
+    if (radiusKm < 0 || nodes.isEmpty()) return {};
+
+    double q[3];
+    toUnitVector(lat, lon, q);
+    const double maxChord = kmToChord(radiusKm);
+
+    QVector<QPair<double, int>> found;
+    searchRadius(0, nodes.size(), 0, q, maxChord * maxChord, found);
+    return toMatches(found);
+}
+
+int SpatialIndex::size() const {
+    return nodes.size();
+}
+
+double SpatialIndex::distanceKm(double lat1, double lon1, double lat2, double lon2) {
+    double a[3], b[3];
+    toUnitVector(lat1, lon1, a);
+    toUnitVector(lat2, lon2, b);
+    return chordToKm(std::sqrt(squaredChord(a, b)));
+}
+
+void SpatialIndex::searchNearest(int begin, int end, int depth, const double *q, int count,
+                                 QVector<QPair<double, int>> &heap) const {
+    if (begin >= end) return;
+
+    const int axis = depth % 3;
+    const int mid = begin + (end - begin) / 2;
+    const Node &node = nodes.at(mid);
+
+    const double d2 = squaredChord(q, node.p);
+    if (heap.size() < count) {
+        heap.append({d2, node.id});
+        std::push_heap(heap.begin(), heap.end());
+    } else if (d2 < heap.front().first) {
+        std::pop_heap(heap.begin(), heap.end());
+        heap.back() = {d2, node.id};
+        std::push_heap(heap.begin(), heap.end());
+    }
+
+    const double diff = q[axis] - node.p[axis];
+    const bool leftFirst = diff < 0;
+    if (leftFirst)
+        searchNearest(begin, mid, depth + 1, q, count, heap);
+    else
+        searchNearest(mid + 1, end, depth + 1, q, count, heap);
+
+    // Druga strona płaszczyzny podziału może zawierać bliższy punkt tylko wtedy,
+    // gdy płaszczyzna jest bliżej niż najgorszy z obecnych kandydatów
+    if (heap.size() < count || diff * diff < heap.front().first) {
+        if (leftFirst)
+            searchNearest(mid + 1, end, depth + 1, q, count, heap);
+        else
+            searchNearest(begin, mid, depth + 1, q, count, heap);
+    }
+}
+
+void SpatialIndex::searchRadius(int begin, int end, int depth, const double *q, double maxChord2,
+                                QVector<QPair<double, int>> &found) const {
+    if (begin >= end) return;
+
+    const int axis = depth % 3;
+    const int mid = begin + (end - begin) / 2;
+    const Node &node = nodes.at(mid);
+
+    const double d2 = squaredChord(q, node.p);
+    if (d2 <= maxChord2)
+        found.append({d2, node.id});
+
+    const double diff = q[axis] - node.p[axis];
+    if (diff < 0 || diff * diff <= maxChord2)
+        searchRadius(begin, mid, depth + 1, q, maxChord2, found);
+    if (diff >= 0 || diff * diff <= maxChord2)
+        searchRadius(mid + 1, end, depth + 1, q, maxChord2, found);
+}
+
+QVector<GeoMatch> SpatialIndex::toMatches(QVector<QPair<double, int>> chords) {
+    std::sort(chords.begin(), chords.end());
+
+    QVector<GeoMatch> matches;
+    matches.reserve(chords.size());
+    for (const auto &chord : std::as_const(chords))
+        matches.append({chord.second, chordToKm(std::sqrt(chord.first))});
+    return matches;
+}
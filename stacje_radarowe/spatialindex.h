@@ -0,0 +1,88 @@
+#ifndef SPATIALINDEX_H
+#define SPATIALINDEX_H
+
+#include <QVector>
+
+/**
+ * @struct GeoPoint
+ * @brief Punkt geograficzny z identyfikatorem obiektu (np. stacji).
+ */
+struct GeoPoint {
+    int id = 0;       /**< Identyfikator obiektu. */
+    double lat = 0.0; /**< Szerokość geograficzna w stopniach. */
+    double lon = 0.0; /**< Długość geograficzna w stopniach. */
+};
+
+/**
+ * @struct GeoMatch
+ * @brief Wynik zapytania przestrzennego: identyfikator i odległość od punktu zapytania.
+ */
+struct GeoMatch {
+    int id = 0;             /**< Identyfikator obiektu. */
+    double distanceKm = 0.0; /**< Odległość po powierzchni Ziemi w kilometrach. */
+};
+
+/**
+ * @class SpatialIndex
+ * @brief Drzewo k-d nad punktami geograficznymi do zapytań "N najbliższych" i "w promieniu".
+ *
+ * Punkty są rzutowane na sferę jednostkową (x, y, z), więc odległość euklidesowa (cięciwa)
+ * jest monotoniczna względem odległości po okręgu wielkim i wyniki są dokładne także
+ * daleko od równika. Drzewo jest przechowywane niejawnie w jednej tablicy: mediana zakresu
+ * jest węzłem, lewa i prawa połowa to poddrzewa.
+ */
+class SpatialIndex {
+public:
+    /**
+     * @brief Tworzy pusty indeks.
+     */
+    SpatialIndex() = default;
+
+    /**
+     * @brief Buduje indeks z listy punktów.
+     * @param points Punkty do zaindeksowania.
+     */
+    explicit SpatialIndex(const QVector<GeoPoint> &points);
+
+    /**
+     * @brief Zwraca najbliższe punkty, posortowane rosnąco po odległości.
+     * @param lat Szerokość geograficzna punktu zapytania.
+     * @param lon Długość geograficzna punktu zapytania.
+     * @param count Maksymalna liczba wyników.
+     */
+    QVector<GeoMatch> nearest(double lat, double lon, int count) const;
+
+    /**
+     * @brief Zwraca punkty w zadanym promieniu, posortowane rosnąco po odległości.
+     * @param lat Szerokość geograficzna punktu zapytania.
+     * @param lon Długość geograficzna punktu zapytania.
+     * @param radiusKm Promień w kilometrach.
+     */
+    QVector<GeoMatch> withinRadius(double lat, double lon, double radiusKm) const;
+
+    /**
+     * @brief Liczba zaindeksowanych punktów.
+     */
+    int size() const;
+
+    /**
+     * @brief Odległość po okręgu wielkim między dwoma punktami.
+     * @return Odległość w kilometrach.
+     */
+    static double distanceKm(double lat1, double lon1, double lat2, double lon2);
+
+private:
+    struct Node {
+        double p[3]; /**< Współrzędne na sferze jednostkowej. */
+        int id;      /**< Identyfikator punktu. */
+    };
+
+    void build(int begin, int end, int depth);
+    void searchNearest(int begin, int end, int depth, const double *q, int count, QVector<QPair<double, int>> &heap) const;
+    void searchRadius(int begin, int end, int depth, const double *q, double maxChord2, QVector<QPair<double, int>> &found) const;
+    static QVector<GeoMatch> toMatches(QVector<QPair<double, int>> chords);
+
+    QVector<Node> nodes; /**< Węzły drzewa w układzie niejawnym. */
+};
+
+#endif // SPATIALINDEX_H
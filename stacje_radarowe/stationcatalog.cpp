@@ -0,0 +1,99 @@
+#include "stationcatalog.h"
+#include <QJsonObject>
+
+StationCatalog::StationCatalog() : d(new Data) {}
+
+StationCatalog StationCatalog::fromJson(const QJsonArray &stations) {
+    StationCatalog catalog;
+    Data *data = catalog.d.data();
+    data->stations.reserve(stations.size());
+    data->byId.reserve(stations.size());
+
+    // Indeks nazwy miasta po znormalizowanym kluczu - każde miasto trafia do cityNames raz
+    QHash<QString, int> cityIndexByKey;
+    QVector<GeoPoint> points;
+    points.reserve(stations.size());
+
+    for (const QJsonValue &val : stations) {
+        const QJsonObject ob = val.toObject();
+        const QJsonValue cityValue = ob.value("city");
+        if (!cityValue.isObject()) continue;
+
+        const QString cityName = cityValue.toObject().value("name").toString();
+        const QString key = normalizeCity(cityName);
+
+        auto cityIt = cityIndexByKey.constFind(key);
+        if (cityIt == cityIndexByKey.constEnd()) {
+            cityIt = cityIndexByKey.insert(key, data->cityNames.size());
+            data->cityNames.append(cityName);
+        }
+
+        Station station;
+        station.id = ob.value("id").toInt();
+        station.cityIndex = cityIt.value();
+        station.name = ob.value("stationName").toString();
+
+        // API podaje współrzędne jako tekst, np. "50.057678"
+        bool latOk = false, lonOk = false;
+        const double lat = ob.value("gegrLat").toString().toDouble(&latOk);
+        const double lon = ob.value("gegrLon").toString().toDouble(&lonOk);
+        if (latOk && lonOk) {
+            station.lat = lat;
+            station.lon = lon;
+            points.append({station.id, lat, lon});
+        }
+
+        const int index = data->stations.size();
+        data->stations.append(station);
+        data->byId.insert(station.id, index);
+        data->byCity[key].append(index);
+    }
+
+    data->spatial = SpatialIndex(points);
+    return catalog;
+}
+
+QString StationCatalog::normalizeCity(const QString &city) {
+    return city.trimmed().toCaseFolded();
+}
+
+QVector<int> StationCatalog::stationIdsInCity(const QString &city) const {
+    QVector<int> ids;
+    const auto it = d->byCity.constFind(normalizeCity(city));
+    if (it == d->byCity.constEnd()) return ids;
+
+    ids.reserve(it->size());
+    for (int index : *it)
+        ids.append(d->stations.at(index).id);
+    return ids;
+}
+
+const Station *StationCatalog::stationById(int id) const {
+    const auto it = d->byId.constFind(id);
+    if (it == d->byId.constEnd()) return nullptr;
+    return &d->stations.at(it.value());
+}
+
+QVector<GeoMatch> StationCatalog::nearestStations(double lat, double lon, int count) const {
+    return d->spatial.nearest(lat, lon, count);
+}
+
+QVector<GeoMatch> StationCatalog::stationsWithinRadius(double lat, double lon, double radiusKm) const {
+    return d->spatial.withinRadius(lat, lon, radiusKm);
+}
+
+QString StationCatalog::cityName(const Station &station) const {
+    return d->cityNames.value(station.cityIndex);
+}
+
+const QVector<Station> &StationCatalog::stations() const {
+    return d->stations;
+}
+
+int StationCatalog::size() const {
+    return d->stations.size();
+}
+
+bool StationCatalog::isEmpty() const {
+    return d->stations.isEmpty();
+}
@@ -0,0 +1,127 @@
+#ifndef STATIONCATALOG_H
+#define STATIONCATALOG_H
+
+#include <QHash>
+#include <QJsonArray>
+#include <QMetaType>
+#include <QSharedData>
+#include <QSharedDataPointer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <limits>
+#include "spatialindex.h"
+
+/**
+ * @struct Station
+ * @brief Zwarty opis stacji pomiarowej wyciągnięty z odpowiedzi station/findAll.
+ */
+struct Station {
+    int id = 0;          /**< Identyfikator stacji. */
+    int cityIndex = -1;  /**< Indeks nazwy miasta w tablicy nazw katalogu. */
+    QString name;        /**< Nazwa stacji. */
+    double lat = std::numeric_limits<double>::quiet_NaN(); /**< Szerokość geograficzna (NaN, jeśli brak). */
+    double lon = std::numeric_limits<double>::quiet_NaN(); /**< Długość geograficzna (NaN, jeśli brak). */
+};
+
+/**
+ * @class StationCatalog
+ * @brief Indeksowany katalog stacji budowany jednorazowo z JSON-a station/findAll.
+ *
+ * Przechowuje stacje jako zwarte struktury, nazwy miast w jednej tablicy (każda nazwa
+ * tylko raz) oraz indeksy: znormalizowana nazwa miasta -> stacje, ID -> stacja
+ * i przestrzenny indeks współrzędnych gegrLat/gegrLon.
+ * Wyszukanie stacji w mieście to jedno sprawdzenie w tablicy haszującej zamiast
+ * przechodzenia całego drzewa JSON.
+ *
+ * Klasa jest współdzielona niejawnie (copy-on-write), więc kopiowanie jej między wątkami
+ * i w sygnałach jest tanie.
+ */
+class StationCatalog {
+public:
+    /**
+     * @brief Tworzy pusty katalog.
+     */
+    StationCatalog();
+
+    /**
+     * @brief Buduje katalog z tablicy JSON zwróconej przez station/findAll.
+     * @param stations Tablica JSON z danymi stacji.
+     * @return Zbudowany katalog.
+     */
+    static StationCatalog fromJson(const QJsonArray &stations);
+
+    /**
+     * @brief Normalizuje nazwę miasta do postaci używanej jako klucz indeksu.
+     * @param city Nazwa miasta wpisana przez użytkownika lub z API.
+     * @return Nazwa bez białych znaków na brzegach, z ujednoliconą wielkością liter.
+     */
+    static QString normalizeCity(const QString &city);
+
+    /**
+     * @brief Zwraca identyfikatory stacji w danym mieście, w kolejności z API.
+     * @param city Nazwa miasta (wielkość liter nie ma znaczenia).
+     */
+    QVector<int> stationIdsInCity(const QString &city) const;
+
+    /**
+     * @brief Zwraca stację o danym identyfikatorze.
+     * @param id Identyfikator stacji.
+     * @return Wskaźnik na stację lub nullptr, jeśli jej nie ma.
+     */
+    const Station *stationById(int id) const;
+
+    /**
+     * @brief Zwraca stacje najbliższe danemu punktowi.
+     * @param lat Szerokość geograficzna punktu.
+     * @param lon Długość geograficzna punktu.
+     * @param count Maksymalna liczba stacji.
+     * @return ID stacji z odległościami, od najbliższej.
+     */
+    QVector<GeoMatch> nearestStations(double lat, double lon, int count) const;
+
+    /**
+     * @brief Zwraca stacje w promieniu od danego punktu.
+     * @param lat Szerokość geograficzna punktu.
+     * @param lon Długość geograficzna punktu.
+     * @param radiusKm Promień w kilometrach.
+     * @return ID stacji z odległościami, od najbliższej.
+     */
+    QVector<GeoMatch> stationsWithinRadius(double lat, double lon, double radiusKm) const;
+
+    /**
+     * @brief Zwraca nazwę miasta stacji.
+     * @param station Stacja z tego katalogu.
+     */
+    QString cityName(const Station &station) const;
+
+    /**
+     * @brief Zwraca wszystkie stacje katalogu.
+     */
+    const QVector<Station> &stations() const;
+
+    /**
+     * @brief Zwraca liczbę stacji w katalogu.
+     */
+    int size() const;
+
+    /**
+     * @brief Sprawdza, czy katalog jest pusty.
+     */
+    bool isEmpty() const;
+
+private:
+    struct Data : public QSharedData {
+        QVector<Station> stations;           /**< Stacje w kolejności z API. */
+        QStringList cityNames;               /**< Nazwy miast, każda raz. */
+        QHash<QString, QVector<int>> byCity; /**< Znormalizowane miasto -> indeksy stacji. */
+        QHash<int, int> byId;                /**< ID stacji -> indeks stacji. */
+        SpatialIndex spatial;                /**< Drzewo k-d po współrzędnych stacji. */
+    };
+
+    QSharedDataPointer<Data> d;
+};
+
+Q_DECLARE_METATYPE(StationCatalog)
+
+#endif // STATIONCATALOG_H
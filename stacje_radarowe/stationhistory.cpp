@@ -0,0 +1,60 @@
+#include "stationhistory.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+
+StationHistory::StationHistory(const QString &path)
+    : path(path)
+{
+}
+
+bool StationHistory::load() {
+    counts.clear();
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    if (!doc.isObject()) return false;
+
+    const QJsonObject object = doc.object();
+    for (auto it = object.begin(); it != object.end(); ++it) {
+        const int stationId = it.key().toInt();
+        const int count = it.value().toInt();
+        if (stationId > 0 && count > 0)
+            counts.insert(stationId, count);
+    }
+    return true;
+}
+
+bool StationHistory::save() const {
+    QJsonObject object;
+    for (auto it = counts.begin(); it != counts.end(); ++it)
+        object.insert(QString::number(it.key()), it.value());
+
+    QDir().mkpath(QFileInfo(path).path());
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    file.write(QJsonDocument(object).toJson(QJsonDocument::Compact));
+    return true;
+}
+
+void StationHistory::recordUse(int stationId) {
+    ++counts[stationId];
+}
+
+int StationHistory::useCount(int stationId) const {
+    return counts.value(stationId);
+}
+
+QVector<int> StationHistory::mostLikely(const QVector<int> &candidates, int count) const {
+    QVector<int> ranked = candidates;
+    std::stable_sort(ranked.begin(), ranked.end(), [this](int a, int b) {
+        return useCount(a) > useCount(b);
+    });
+    if (ranked.size() > count)
+        ranked.resize(std::max(count, 0));
+    return ranked;
+}
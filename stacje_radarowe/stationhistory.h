@@ -0,0 +1,62 @@
+#ifndef STATIONHISTORY_H
+#define STATIONHISTORY_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+/**
+ * @class StationHistory
+ * @brief Lokalna historia wyborów stacji: ile razy użytkownik wybrał każdą stację.
+ *
+ * Służy do przewidywania, które stacje z listy zostaną wybrane jako następne
+ * (prefetch sensorów i danych). Zapisywana jako JSON {"id": liczba_wyborów}.
+ */
+class StationHistory {
+public:
+    /**
+     * @brief Tworzy pustą historię związaną z plikiem.
+     * @param path Ścieżka pliku historii.
+     */
+    explicit StationHistory(const QString &path = "offline/historia_stacji.json");
+
+    /**
+     * @brief Wczytuje historię z pliku (brak pliku oznacza pustą historię).
+     * @return true, jeśli plik istniał i był poprawny.
+     */
+    bool load();
+
+    /**
+     * @brief Zapisuje historię do pliku.
+     * @return true, jeśli zapis się udał.
+     */
+    bool save() const;
+
+    /**
+     * @brief Zapamiętuje wybór stacji.
+     * @param stationId Identyfikator stacji.
+     */
+    void recordUse(int stationId);
+
+    /**
+     * @brief Liczba zapamiętanych wyborów stacji.
+     * @param stationId Identyfikator stacji.
+     */
+    int useCount(int stationId) const;
+
+    /**
+     * @brief Wybiera najczęściej używane stacje spośród kandydatów.
+     *
+     * Przy równej liczbie wyborów zachowuje kolejność kandydatów, więc bez historii
+     * zwraca pierwsze count stacji z listy.
+     * @param candidates Stacje w kolejności listy.
+     * @param count Największa liczba zwróconych stacji.
+     */
+    QVector<int> mostLikely(const QVector<int> &candidates, int count) const;
+
+private:
+    QString path;            /**< Ścieżka pliku historii. */
+    QHash<int, int> counts;  /**< Liczba wyborów każdej stacji. */
+};
+
+#endif // STATIONHISTORY_H
@@ -2,12 +2,30 @@
 #include <gmock/gmock.h>
 #include <QApplication>
 #include <QtTest/QSignalSpy>
+#include <QTest>
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QJsonValue>
+#include <QTimer>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QFile>
+#include <QSettings>
+#include <QSet>
+#include <limits>
+#include "httpcache.h"
+#include "stationcatalog.h"
+#include "stationhistory.h"
+#include "seriesfile.h"
+#include "seriesstreamparser.h"
+#include "timestampparser.h"
+#include "downsampler.h"
+#include "measurementtablemodel.h"
+#include "mockgiosserver.h"
 #include "mainwindow.h"
 #include "apiworker.h"
+#include "batcharchiver.h"
 
 // Globalna zmienna dla QApplication
 int global_argc = 1;
@@ -44,6 +62,75 @@ public:
     MOCK_METHOD1(get, QNetworkReply*(const QNetworkRequest &request));
 };
 
+// Odpowiedź sieciowa z gotowym ciałem, kończona asynchronicznie w pętli zdarzeń
+class FakeNetworkReply : public QNetworkReply {
+public:
+    FakeNetworkReply(const QNetworkRequest &request, const QByteArray &body, int delayMs, QObject *parent = nullptr,
+                     NetworkError failure = NoError)
+        : QNetworkReply(parent), body(body) {
+        setRequest(request);
+        setUrl(request.url());
+        setOperation(QNetworkAccessManager::GetOperation);
+        open(QIODevice::ReadOnly);
+        QTimer::singleShot(delayMs, this, [this, failure]() {
+            if (isFinished()) return;
+            if (failure != NoError) {
+                this->body.clear();
+                setAttribute(QNetworkRequest::HttpStatusCodeAttribute, 503);
+                setError(failure, "Service unavailable");
+                emit errorOccurred(failure);
+            }
+            setFinished(true);
+            emit finished();
+        });
+    }
+    void abort() override {
+        if (isFinished()) return;
+        setError(OperationCanceledError, "Operation canceled");
+        setFinished(true);
+        emit errorOccurred(OperationCanceledError);
+        emit finished();
+    }
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override { return body.size() - offset + QIODevice::bytesAvailable(); }
+protected:
+    qint64 readData(char *data, qint64 maxSize) override {
+        const qint64 n = qMin(maxSize, qint64(body.size()) - offset);
+        memcpy(data, body.constData() + offset, n);
+        offset += n;
+        return n;
+    }
+private:
+    QByteArray body;
+    qint64 offset = 0;
+};
+
+// Manager sieciowy serwujący odpowiedzi z mapy ścieżka -> treść, bez dostępu do sieci.
+// Podmienia createRequest(), więc działa także przy wywołaniach przez wskaźnik na klasę bazową.
+class FakeNetworkAccessManager : public QNetworkAccessManager {
+public:
+    FakeNetworkAccessManager(QObject *parent = nullptr) : QNetworkAccessManager(parent) {}
+    QHash<QString, QByteArray> responses;
+    QHash<QString, int> delays;
+    QHash<QString, int> failures; // ile kolejnych żądań o ścieżkę kończy się błędem 503
+    QHash<QString, QNetworkRequest::Priority> priorities; // priorytet ostatniego żądania o ścieżkę
+    int requestCount = 0;
+protected:
+    QNetworkReply *createRequest(Operation op, const QNetworkRequest &request, QIODevice *outgoingData) override {
+        Q_UNUSED(op);
+        Q_UNUSED(outgoingData);
+        ++requestCount;
+        const QString path = request.url().path();
+        priorities[path] = request.priority();
+        QNetworkReply::NetworkError failure = QNetworkReply::NoError;
+        if (failures.value(path) > 0) {
+            --failures[path];
+            failure = QNetworkReply::ServiceUnavailableError;
+        }
+        return new FakeNetworkReply(request, responses.value(path), delays.value(path, 0), this, failure);
+    }
+};
+
 // Fixture testowy dla MainWindow i ApiWorker
 class MainWindowTest : public ::testing::Test {
 protected:
@@ -80,6 +167,72 @@ TEST_F(MainWindowTest, Initialization) {
     ASSERT_TRUE(window->findChild<QComboBox*>("comboZakres")->count() > 0);
 }
 
+// Test trybu rysowania: Auto liczy punkty po decymacji do szerokości wykresu, a nie surowe
+TEST_F(MainWindowTest, ChartRenderMode_AutoCountsDrawnPoints) {
+    window->findChild<QComboBox*>("comboSensory")->addItem("PM10", 11);
+
+    MeasurementSeries series;
+    series.sensorId = 11;
+    for (int i = 0; i < 50000; ++i) {
+        series.timestamps.append(qint64(i) * 60000);
+        series.values.append(i % 100);
+    }
+
+    for (MainWindow::ChartRenderMode mode : {MainWindow::ChartRenderMode::Auto, MainWindow::ChartRenderMode::Software}) {
+        window->setChartRenderMode(mode);
+        ASSERT_TRUE(QMetaObject::invokeMethod(window, "handleSeriesFetched", Q_ARG(SeriesSlice, SeriesSlice::make(series))));
+
+        QChartView *chartView = window->findChild<QChartView*>("chartView");
+        ASSERT_EQ(chartView->chart()->series().size(), 1);
+        QXYSeries *drawn = qobject_cast<QXYSeries*>(chartView->chart()->series().first());
+        ASSERT_NE(drawn, nullptr);
+        ASSERT_GT(drawn->count(), 2);
+        ASSERT_LT(drawn->count(), 10000);
+        ASSERT_FALSE(drawn->useOpenGL());
+    }
+}
+
+// Test odrzucania spóźnionych odpowiedzi: sensory i seria muszą dotyczyć bieżącego wyboru
+TEST_F(MainWindowTest, StaleSensorsAndSeriesAreIgnored) {
+    QComboBox *comboStacje = window->findChild<QComboBox*>("comboStacje");
+    QComboBox *comboSensory = window->findChild<QComboBox*>("comboSensory");
+    {
+        QSignalBlocker blocker(comboStacje);
+        comboStacje->addItem("Stacja 1", 1);
+        comboStacje->addItem("Stacja 2", 2);
+        comboStacje->setCurrentIndex(0);
+    }
+
+    QJsonObject param;
+    param["paramName"] = "PM10";
+    QJsonObject sensor;
+    sensor["id"] = 201;
+    sensor["param"] = param;
+    QJsonArray sensors;
+    sensors.append(sensor);
+
+    ASSERT_TRUE(QMetaObject::invokeMethod(window, "handleSensorsFetched", Q_ARG(QJsonArray, sensors), Q_ARG(int, 2)));
+    ASSERT_EQ(comboSensory->findData(201), -1);
+
+    sensor["id"] = 101;
+    sensors[0] = sensor;
+    ASSERT_TRUE(QMetaObject::invokeMethod(window, "handleSensorsFetched", Q_ARG(QJsonArray, sensors), Q_ARG(int, 1)));
+    ASSERT_EQ(comboSensory->currentData().toInt(), 101);
+
+    MeasurementSeries series;
+    series.timestamps = {0, 3600000};
+    series.values = {10, 20};
+    QChartView *chartView = window->findChild<QChartView*>("chartView");
+
+    series.sensorId = 201;
+    ASSERT_TRUE(QMetaObject::invokeMethod(window, "handleSeriesFetched", Q_ARG(SeriesSlice, SeriesSlice::make(series))));
+    ASSERT_TRUE(chartView->chart()->series().isEmpty());
+
+    series.sensorId = 101;
+    ASSERT_TRUE(QMetaObject::invokeMethod(window, "handleSeriesFetched", Q_ARG(SeriesSlice, SeriesSlice::make(series))));
+    ASSERT_EQ(chartView->chart()->series().size(), 1);
+}
+
 // Test pobierania stacji przez ApiWorker
 TEST_F(MainWindowTest, ApiWorker_FetchStations_Success) {
     // Przygotuj dane odpowiedzi
@@ -185,6 +338,829 @@ TEST_F(MainWindowTest, ApiWorker_Threading) {
     ASSERT_EQ(worker->thread(), workerThread);
 }
 
+// Test przypisywania równoległych odpowiedzi do właściwych sensorów
+TEST_F(MainWindowTest, ApiWorker_FetchData_ConcurrentRepliesKeepSensorId) {
+    FakeNetworkAccessManager *fakeManager = new FakeNetworkAccessManager(worker);
+    worker->manager = fakeManager;
+    fakeManager->responses["/pjp-api/rest/data/getData/11"] = R"({"key":"PM10","values":[]})";
+    fakeManager->responses["/pjp-api/rest/data/getData/12"] = R"({"key":"NO2","values":[]})";
+    // Pierwsze żądanie kończy się jako drugie
+    fakeManager->delays["/pjp-api/rest/data/getData/11"] = 50;
+
+    QSignalSpy spy(worker, &ApiWorker::dataFetched);
+    worker->fetchData(11);
+    worker->fetchData(12);
+
+    while (spy.count() < 2 && spy.wait(1000)) {}
+    ASSERT_EQ(spy.count(), 2);
+
+    QHash<int, QString> keys;
+    for (const QList<QVariant> &arguments : spy)
+        keys[arguments.at(1).toInt()] = arguments.at(0).value<QJsonObject>()["key"].toString();
+    ASSERT_EQ(keys.value(11), "PM10");
+    ASSERT_EQ(keys.value(12), "NO2");
+}
+
+// Test migawki stacji: lista sensorów + równoległe dane wszystkich sensorów
+TEST_F(MainWindowTest, ApiWorker_FetchStationSnapshot_AggregatesAllSensors) {
+    FakeNetworkAccessManager *fakeManager = new FakeNetworkAccessManager(worker);
+    worker->manager = fakeManager;
+    fakeManager->responses["/pjp-api/rest/station/sensors/944"] =
+        R"([{"id":11,"param":{"paramName":"pył zawieszony PM10"}},{"id":12,"param":{"paramName":"dwutlenek azotu"}}])";
+    fakeManager->responses["/pjp-api/rest/data/getData/11"] = R"({"key":"PM10","values":[{"date":"2025-01-01 10:00:00","value":12.5}]})";
+    fakeManager->responses["/pjp-api/rest/data/getData/12"] = R"({"key":"NO2","values":[]})";
+
+    QSignalSpy spy(worker, &ApiWorker::stationSnapshotFetched);
+    worker->fetchStationSnapshot(944);
+
+    ASSERT_TRUE(spy.wait(1000));
+    ASSERT_EQ(spy.count(), 1);
+    QList<QVariant> arguments = spy.takeFirst();
+    QJsonArray sensors = arguments.at(0).value<QJsonArray>();
+
+    ASSERT_EQ(sensors.size(), 2);
+    ASSERT_EQ(arguments.at(1).toInt(), 944);
+    QVector<SeriesSlice> slices = arguments.at(2).value<QVector<SeriesSlice>>();
+    ASSERT_EQ(slices.size(), 2);
+    QHash<int, QString> keys;
+    for (const SeriesSlice &slice : slices)
+        keys[slice.series.sensorId] = slice.series.key;
+    ASSERT_EQ(keys.value(11), "PM10");
+    ASSERT_EQ(keys.value(12), "NO2");
+    ASSERT_EQ(fakeManager->requestCount, 3);
+}
+
+// Test łączenia identycznych żądań w locie: jeden GET, wynik dla obu wywołań
+TEST_F(MainWindowTest, ApiWorker_FetchData_CoalescesDuplicateRequests) {
+    FakeNetworkAccessManager *fakeManager = new FakeNetworkAccessManager(worker);
+    worker->manager = fakeManager;
+    fakeManager->responses["/pjp-api/rest/data/getData/11"] = R"({"key":"PM10","values":[{"date":"2025-01-01 10:00:00","value":12.5}]})";
+    fakeManager->delays["/pjp-api/rest/data/getData/11"] = 50;
+
+    QSignalSpy spy(worker, &ApiWorker::seriesFetched);
+    worker->fetchData(11);
+    worker->fetchData(11);
+
+    ASSERT_TRUE(spy.wait(1000));
+    if (spy.count() < 2) spy.wait(200);
+    ASSERT_EQ(spy.count(), 2);
+    ASSERT_EQ(fakeManager->requestCount, 1);
+    ASSERT_EQ(worker->coalescedRequestCount(), 1);
+}
+
+// Test zmiany wyboru stacji: starsze żądanie sensorów jest przerywane, a jego wynik pomijany
+TEST_F(MainWindowTest, ApiWorker_FetchSensors_SupersededRequestIsAborted) {
+    FakeNetworkAccessManager *fakeManager = new FakeNetworkAccessManager(worker);
+    worker->manager = fakeManager;
+    fakeManager->responses["/pjp-api/rest/station/sensors/1"] = R"([{"id":11}])";
+    fakeManager->responses["/pjp-api/rest/station/sensors/2"] = R"([{"id":21}])";
+    fakeManager->delays["/pjp-api/rest/station/sensors/1"] = 50;
+
+    QSignalSpy spy(worker, &ApiWorker::sensorsFetched);
+    QSignalSpy errorSpy(worker, &ApiWorker::networkError);
+    worker->fetchSensors(1, true);
+    worker->fetchSensors(2, true);
+
+    ASSERT_TRUE(spy.wait(1000));
+    spy.wait(100);
+    ASSERT_EQ(spy.count(), 1);
+    ASSERT_EQ(spy.takeFirst().at(1).toInt(), 2);
+    ASSERT_EQ(worker->abortedRequestCount(), 1);
+    ASSERT_EQ(errorSpy.count(), 0);
+}
+
+// Test ponawiania: dwa błędy 503, trzecia próba po odczekaniu kończy się sukcesem
+TEST_F(MainWindowTest, ApiWorker_FetchData_RetriesTransientErrors) {
+    FakeNetworkAccessManager *fakeManager = new FakeNetworkAccessManager(worker);
+    worker->manager = fakeManager;
+    fakeManager->responses["/pjp-api/rest/data/getData/11"] = R"({"key":"PM10","values":[]})";
+    fakeManager->failures["/pjp-api/rest/data/getData/11"] = 2;
+
+    RetryPolicy policy;
+    policy.baseDelayMs = 10;
+    worker->setRetryPolicy(policy);
+
+    QSignalSpy spy(worker, &ApiWorker::seriesFetched);
+    QSignalSpy errorSpy(worker, &ApiWorker::networkError);
+    worker->fetchData(11);
+
+    ASSERT_TRUE(spy.wait(2000));
+    ASSERT_EQ(fakeManager->requestCount, 3);
+    ASSERT_EQ(worker->retriedRequestCount(), 2);
+    ASSERT_EQ(errorSpy.count(), 0);
+}
+
+// Test wyłącznika obwodu: otwarcie po progu błędów, próba po czasie otwarcia, zamknięcie po sukcesie
+TEST(CircuitBreakerTest, OpensAfterFailuresAndProbesAfterCooldown) {
+    RetryPolicy policy;
+    policy.failureThreshold = 2;
+    policy.openDurationMs = 1000;
+    CircuitBreaker breaker;
+    breaker.setPolicy(policy);
+
+    breaker.recordFailure("api", 0);
+    ASSERT_TRUE(breaker.allowRequest("api", 10));
+    breaker.recordFailure("api", 10);
+    ASSERT_TRUE(breaker.isOpen("api", 500));
+    ASSERT_FALSE(breaker.allowRequest("api", 500));
+    ASSERT_TRUE(breaker.allowRequest("other", 500));
+
+    // Po czasie otwarcia jedna próba; nieudana otwiera obwód ponownie
+    ASSERT_TRUE(breaker.allowRequest("api", 1100));
+    ASSERT_FALSE(breaker.allowRequest("api", 1150));
+    breaker.recordFailure("api", 1200);
+    ASSERT_FALSE(breaker.allowRequest("api", 2000));
+
+    ASSERT_TRUE(breaker.allowRequest("api", 2300));
+    breaker.recordSuccess("api");
+    ASSERT_FALSE(breaker.isOpen("api", 2300));
+    ASSERT_TRUE(breaker.allowRequest("api", 2300));
+}
+
+// Test kubełka żetonów: burst od razu, potem żeton co 1/rate sekundy
+TEST(TokenBucketTest, AllowsBurstThenRefillsAtRate) {
+    TokenBucket bucket;
+    bucket.rate = 2.0;
+    bucket.burst = 2.0;
+    bucket.tokens = 2.0;
+
+    ASSERT_TRUE(bucket.tryTake(0));
+    ASSERT_TRUE(bucket.tryTake(0));
+    ASSERT_FALSE(bucket.tryTake(100));
+    ASSERT_EQ(bucket.msUntilToken(100), 400);
+    ASSERT_TRUE(bucket.tryTake(500));
+
+    // Po długiej przerwie kubełek nie przekracza pojemności
+    ASSERT_TRUE(bucket.tryTake(10000));
+    ASSERT_TRUE(bucket.tryTake(10000));
+    ASSERT_FALSE(bucket.tryTake(10000));
+}
+
+// Test ogranicznika tempa: nadmiarowe żądania czekają w kolejce i wychodzą, gdy są żetony
+TEST_F(MainWindowTest, ApiWorker_FetchData_RateLimitQueuesExcessRequests) {
+    FakeNetworkAccessManager *fakeManager = new FakeNetworkAccessManager(worker);
+    worker->manager = fakeManager;
+    for (int sensorId : {11, 12, 13})
+        fakeManager->responses[QString("/pjp-api/rest/data/getData/%1").arg(sensorId)] = R"({"key":"PM10","values":[]})";
+    worker->setRateLimit(RequestScheduler::DataClass, 20.0, 1);
+
+    QSignalSpy spy(worker, &ApiWorker::seriesFetched);
+    worker->fetchData(11);
+    worker->fetchData(12);
+    worker->fetchData(13);
+    ASSERT_EQ(fakeManager->requestCount, 1);
+    ASSERT_EQ(worker->queuedRequestCount(), 2);
+
+    while (spy.count() < 3 && spy.wait(1000)) {}
+    ASSERT_EQ(spy.count(), 3);
+    ASSERT_EQ(fakeManager->requestCount, 3);
+    ASSERT_EQ(worker->queuedRequestCount(), 0);
+}
+
+// Test ogranicznika tempa w wątku roboczym: wybudzenie harmonogramu przenosi się razem z ApiWorker
+TEST_F(MainWindowTest, ApiWorker_FetchData_RateLimitWorksAfterMoveToThread) {
+    ApiWorker *threadWorker = new ApiWorker();
+    FakeNetworkAccessManager *fakeManager = new FakeNetworkAccessManager(threadWorker);
+    threadWorker->manager = fakeManager;
+    for (int sensorId : {11, 12, 13})
+        fakeManager->responses[QString("/pjp-api/rest/data/getData/%1").arg(sensorId)] = R"({"key":"PM10","values":[]})";
+    threadWorker->setRateLimit(RequestScheduler::DataClass, 20.0, 1);
+
+    QThread thread;
+    threadWorker->moveToThread(&thread);
+    thread.start();
+
+    QObject receiver;
+    int fetched = 0;
+    QObject::connect(threadWorker, &ApiWorker::seriesFetched, &receiver, [&fetched]() { ++fetched; });
+    for (int sensorId : {11, 12, 13})
+        QMetaObject::invokeMethod(threadWorker, [threadWorker, sensorId]() { threadWorker->fetchData(sensorId); }, Qt::QueuedConnection);
+
+    const bool allFetched = QTest::qWaitFor([&fetched]() { return fetched == 3; }, 2000);
+    thread.quit();
+    thread.wait();
+    delete threadWorker;
+    ASSERT_TRUE(allFetched);
+}
+
+// Test priorytetów: żądanie interaktywne omija limit połączeń i kolejkę pracy w tle
+TEST_F(MainWindowTest, ApiWorker_FetchData_InteractiveRequestsPreemptBackground) {
+    FakeNetworkAccessManager *fakeManager = new FakeNetworkAccessManager(worker);
+    worker->manager = fakeManager;
+    for (int sensorId : {11, 12, 13})
+        fakeManager->responses[QString("/pjp-api/rest/data/getData/%1").arg(sensorId)] = R"({"key":"PM10","values":[]})";
+    fakeManager->delays["/pjp-api/rest/data/getData/11"] = 50;
+    worker->setMaxConcurrent(RequestScheduler::Background, 1);
+
+    const qint64 min = std::numeric_limits<qint64>::min();
+    const qint64 max = std::numeric_limits<qint64>::max();
+    QSignalSpy spy(worker, &ApiWorker::seriesFetched);
+    worker->fetchData(11, min, max, false, RequestScheduler::Background);
+    worker->fetchData(12, min, max, false, RequestScheduler::Background);
+    worker->fetchData(13);
+    ASSERT_EQ(fakeManager->requestCount, 2);
+    ASSERT_EQ(worker->queuedRequestCount(), 1);
+
+    while (spy.count() < 3 && spy.wait(1000)) {}
+    ASSERT_EQ(spy.count(), 3);
+    ASSERT_EQ(spy.at(0).at(0).value<SeriesSlice>().series.sensorId, 13);
+    ASSERT_EQ(spy.at(2).at(0).value<SeriesSlice>().series.sensorId, 12);
+    ASSERT_EQ(fakeManager->priorities.value("/pjp-api/rest/data/getData/13"), QNetworkRequest::HighPriority);
+    ASSERT_EQ(fakeManager->priorities.value("/pjp-api/rest/data/getData/12"), QNetworkRequest::LowPriority);
+}
+
+// Test prefetchu: sensory i dane pobrane w tle obsługują następny wybór bez żądania do API
+TEST_F(MainWindowTest, ApiWorker_PrefetchStations_ServesNextInteractiveFetch) {
+    FakeNetworkAccessManager *fakeManager = new FakeNetworkAccessManager(worker);
+    worker->manager = fakeManager;
+    fakeManager->responses["/pjp-api/rest/station/sensors/944"] = R"([{"id":11,"param":{"paramName":"pył zawieszony PM10"}}])";
+    fakeManager->responses["/pjp-api/rest/data/getData/11"] = R"({"key":"PM10","values":[{"date":"2025-01-01 10:00:00","value":12.5}]})";
+
+    worker->prefetchStations({944});
+    for (int i = 0; i < 100 && fakeManager->requestCount < 2; ++i)
+        QTest::qWait(10);
+    QTest::qWait(50);
+    ASSERT_EQ(fakeManager->requestCount, 2);
+
+    QSignalSpy sensorsSpy(worker, &ApiWorker::sensorsFetched);
+    QSignalSpy seriesSpy(worker, &ApiWorker::seriesFetched);
+    worker->fetchSensors(944, true);
+    worker->fetchData(11);
+    ASSERT_EQ(sensorsSpy.count(), 1);
+    ASSERT_EQ(seriesSpy.count(), 1);
+    ASSERT_EQ(fakeManager->requestCount, 2);
+    ASSERT_EQ(worker->prefetchHitCount(), 2);
+}
+
+// Test prefetchu: odpowiedź, do której dołączył użytkownik, nie obsłuży jego następnego odświeżenia
+TEST_F(MainWindowTest, ApiWorker_PrefetchStations_JoinedReplyIsNotReused) {
+    FakeNetworkAccessManager *fakeManager = new FakeNetworkAccessManager(worker);
+    worker->manager = fakeManager;
+    fakeManager->responses["/pjp-api/rest/station/sensors/944"] = R"([{"id":11,"param":{"paramName":"pył zawieszony PM10"}}])";
+    fakeManager->responses["/pjp-api/rest/data/getData/11"] = R"({"key":"PM10","values":[]})";
+    fakeManager->delays["/pjp-api/rest/station/sensors/944"] = 50;
+
+    QSignalSpy sensorsSpy(worker, &ApiWorker::sensorsFetched);
+    worker->prefetchStations({944});
+    worker->fetchSensors(944, true);
+    ASSERT_TRUE(sensorsSpy.wait(1000));
+    for (int i = 0; i < 100 && fakeManager->requestCount < 2; ++i)
+        QTest::qWait(10);
+    QTest::qWait(50);
+    ASSERT_EQ(fakeManager->requestCount, 2);
+
+    // Sensory: ponowne pobranie idzie do API; dane sensora: nadal z prefetchu
+    worker->fetchSensors(944, true);
+    ASSERT_EQ(fakeManager->requestCount, 3);
+    ASSERT_EQ(worker->prefetchHitCount(), 0);
+    QSignalSpy seriesSpy(worker, &ApiWorker::seriesFetched);
+    worker->fetchData(11);
+    ASSERT_EQ(seriesSpy.count(), 1);
+    ASSERT_EQ(worker->prefetchHitCount(), 1);
+    ASSERT_TRUE(sensorsSpy.wait(1000));
+}
+
+// Test end-to-end przez prawdziwe gniazdo: migawka stacji z lokalnego serwera GIOŚ
+TEST_F(MainWindowTest, ApiWorker_FetchStationSnapshot_FromMockServer) {
+    MockGiosServer server;
+    server.setLatency(100);
+    server.setSensorsPerStation(4);
+    ASSERT_TRUE(server.start());
+
+    worker->manager = new QNetworkAccessManager(worker);
+    worker->setBaseUrl(server.baseUrl());
+
+    QSignalSpy spy(worker, &ApiWorker::stationSnapshotFetched);
+    worker->fetchStationSnapshot(7);
+
+    ASSERT_TRUE(spy.wait(5000));
+    QList<QVariant> arguments = spy.takeFirst();
+    QVector<SeriesSlice> slices = arguments.at(2).value<QVector<SeriesSlice>>();
+    ASSERT_EQ(slices.size(), 4);
+    ASSERT_EQ(slices.first().series.size(), 72);
+    ASSERT_EQ(server.requestCount(), 5);
+    // Dane sensorów są pobierane równolegle, nie po kolei
+    ASSERT_GE(server.maxConcurrentRequests(), 2);
+}
+
+// Test trybu wsadowego na lokalnym serwerze GIOŚ: kody wyjścia, limit równoległości i pliki offline
+TEST_F(MainWindowTest, BatchArchiver_ExitCodesAndOfflineFiles) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    MockGiosServer server;
+    server.setStationCount(12); // Gdańsk: stacje 6 i 12
+    server.setSensorsPerStation(1);
+    server.setLatency(10);
+    ASSERT_TRUE(server.start());
+
+    auto run = [](const QUrl &baseUrl, const QStringList &cities, const QVector<int> &stationIds) {
+        ApiWorker apiWorker;
+        apiWorker.setBaseUrl(baseUrl);
+        RetryPolicy policy;
+        policy.maxAttempts = 1;
+        apiWorker.setRetryPolicy(policy);
+        BatchArchiver archiver(&apiWorker);
+        archiver.setMaxConcurrent(1);
+
+        QSignalSpy spy(&archiver, &BatchArchiver::finished);
+        archiver.start(cities, stationIds);
+        if (spy.isEmpty()) spy.wait(5000);
+        return spy.isEmpty() ? -1 : spy.first().first().toInt();
+    };
+
+    // Pliki offline powstają względem katalogu roboczego
+    const QString previousDir = QDir::currentPath();
+    ASSERT_TRUE(QDir::setCurrent(dir.path()));
+    const int success = run(server.baseUrl(), {"Gdańsk"}, {});
+    const int maxConcurrent = server.maxConcurrentRequests();
+    const int partial = run(server.baseUrl(), {"Atlantyda"}, {7});
+    const int listFailed = run(QUrl("http://127.0.0.1:1/pjp-api/rest/"), {"Gdańsk"}, {});
+    QDir::setCurrent(previousDir);
+
+    ASSERT_EQ(success, BatchArchiver::Success);
+    // Jedna stacja naraz, jeden sensor na stację - żądania idą po kolei
+    ASSERT_EQ(maxConcurrent, 1);
+    ASSERT_TRUE(QFile::exists(dir.filePath("offline/stacje.json")));
+    ASSERT_TRUE(QFile::exists(dir.filePath("offline/sensory_6.json")));
+    ASSERT_TRUE(QFile::exists(dir.filePath("offline/sensory_12.json")));
+    SeriesFile file;
+    ASSERT_TRUE(file.open(dir.filePath(SeriesFile::offlinePath(1200))));
+    ASSERT_EQ(file.count(), 72);
+
+    ASSERT_EQ(partial, BatchArchiver::PartialFailure);
+    ASSERT_TRUE(QFile::exists(dir.filePath("offline/sensory_7.json")));
+    ASSERT_EQ(listFailed, BatchArchiver::StationListFailed);
+}
+
+// Test trybu wsadowego: błąd stacji z --station w trakcie pobierania listy stacji nie kończy zadania
+TEST_F(MainWindowTest, BatchArchiver_StationErrorWhileListPendingIsPartialFailure) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString previousDir = QDir::currentPath();
+    ASSERT_TRUE(QDir::setCurrent(dir.path()));
+
+    int exitCode = -1, done = 0, failed = 0;
+    {
+        ApiWorker apiWorker;
+        FakeNetworkAccessManager *fakeManager = new FakeNetworkAccessManager(&apiWorker);
+        apiWorker.manager = fakeManager;
+        fakeManager->responses["/pjp-api/rest/station/findAll"] = R"([{"id":1,"stationName":"Testowo","city":{"name":"Testowo"}}])";
+        fakeManager->delays["/pjp-api/rest/station/findAll"] = 100;
+        fakeManager->responses["/pjp-api/rest/station/sensors/1"] = R"([{"id":11}])";
+        fakeManager->responses["/pjp-api/rest/data/getData/11"] = R"({"key":"PM10","values":[]})";
+        fakeManager->responses["/pjp-api/rest/station/sensors/944"] = R"([{"id":9441}])";
+        fakeManager->failures["/pjp-api/rest/data/getData/9441"] = 1;
+        RetryPolicy policy;
+        policy.maxAttempts = 1;
+        apiWorker.setRetryPolicy(policy);
+
+        BatchArchiver archiver(&apiWorker);
+        QSignalSpy spy(&archiver, &BatchArchiver::finished);
+        archiver.start({"Testowo"}, {944});
+        if (spy.isEmpty()) spy.wait(2000);
+        exitCode = spy.isEmpty() ? -1 : spy.first().first().toInt();
+        done = archiver.stationsDone();
+        failed = archiver.stationsFailed();
+    }
+    QDir::setCurrent(previousDir);
+
+    ASSERT_EQ(exitCode, BatchArchiver::PartialFailure);
+    ASSERT_EQ(done, 1);
+    ASSERT_EQ(failed, 1);
+}
+
+// Test kolejności nakładania konfiguracji endpointów: domyślne, plik INI, środowisko
+TEST(ApiEndpointsTest, LayersDefaultsSettingsAndEnvironment) {
+    ApiEndpoints defaults;
+    ASSERT_EQ(defaults.sensorsUrl(944).toString(), "https://api.gios.gov.pl/pjp-api/rest/station/sensors/944");
+
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString iniPath = dir.filePath("stacje_radarowe.ini");
+    {
+        QSettings settings(iniPath, QSettings::IniFormat);
+        settings.setValue("api/base_url", "http://proxy.local:8080/gios");
+        settings.setValue("api/data_path", "v2/data/{id}");
+    }
+
+    ApiEndpoints endpoints;
+    endpoints.loadSettings(iniPath);
+    ASSERT_EQ(endpoints.stationsUrl().toString(), "http://proxy.local:8080/gios/station/findAll");
+    ASSERT_EQ(endpoints.dataUrl(6085).toString(), "http://proxy.local:8080/gios/v2/data/6085");
+
+    qputenv("GIOS_API_BASE_URL", "http://mirror.local/rest/");
+    endpoints.loadEnvironment();
+    qunsetenv("GIOS_API_BASE_URL");
+    ASSERT_EQ(endpoints.dataUrl(6085).toString(), "http://mirror.local/rest/v2/data/6085");
+}
+
+// Test historii wyborów stacji: ranking według liczby użyć i zapis/odczyt pliku
+TEST(StationHistoryTest, RanksByUseAndSurvivesReload) {
+    QTemporaryDir dir;
+    const QString path = dir.filePath("historia_stacji.json");
+
+    StationHistory history(path);
+    ASSERT_FALSE(history.load());
+    ASSERT_EQ(history.mostLikely({1, 2, 3, 4}, 2), QVector<int>({1, 2}));
+
+    history.recordUse(3);
+    history.recordUse(3);
+    history.recordUse(4);
+    ASSERT_TRUE(history.save());
+
+    StationHistory reloaded(path);
+    ASSERT_TRUE(reloaded.load());
+    ASSERT_EQ(reloaded.useCount(3), 2);
+    ASSERT_EQ(reloaded.mostLikely({1, 2, 3, 4}, 3), QVector<int>({3, 4, 1}));
+}
+
+// Test nadpisywania polityki cache serwera konfigurowalnym max-age
+TEST(HttpCacheTest, AppliesMaxAgeAndKeepsValidators) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    HttpCache cache(dir.path());
+    cache.setMaxAge(3600);
+
+    const QUrl url("https://api.gios.gov.pl/pjp-api/rest/station/findAll");
+    QNetworkCacheMetaData metaData;
+    metaData.setUrl(url);
+    metaData.setSaveToDisk(false);
+    metaData.setRawHeaders({{"Cache-Control", "no-cache"}, {"ETag", "\"abc\""}});
+
+    QIODevice *device = cache.prepare(metaData);
+    ASSERT_NE(device, nullptr);
+    device->write("[]");
+    cache.insert(device);
+
+    QNetworkCacheMetaData stored = cache.metaData(url);
+    ASSERT_TRUE(stored.isValid());
+    ASSERT_TRUE(stored.saveToDisk());
+    const qint64 secondsLeft = QDateTime::currentDateTimeUtc().secsTo(stored.expirationDate());
+    ASSERT_GT(secondsLeft, 3500);
+    ASSERT_LE(secondsLeft, 3600);
+    ASSERT_EQ(stored.rawHeaders().size(), 1);
+    ASSERT_EQ(stored.rawHeaders().first().first, QByteArray("ETag"));
+}
+
+// Test listy stacji z cache HTTP: ważny wpis bez żądania do API, przeterminowany rewalidowany (304)
+TEST_F(MainWindowTest, ApiWorker_FetchStations_ServesFreshCacheAndRevalidatesExpired) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    MockGiosServer server;
+    server.setStationCount(3);
+    ASSERT_TRUE(server.start());
+
+    // Cache HTTP i pliki offline powstają względem katalogu roboczego
+    const QString previousDir = QDir::currentPath();
+    ASSERT_TRUE(QDir::setCurrent(dir.path()));
+    int stationsCount = 0, afterFirst = 0, afterExpired = 0, afterFresh = 0;
+    {
+        ApiWorker apiWorker;
+        apiWorker.setBaseUrl(server.baseUrl());
+        QSignalSpy spy(&apiWorker, &ApiWorker::stationsFetched);
+        auto fetch = [&]() {
+            const int count = spy.count();
+            apiWorker.fetchStations("Warszawa");
+            if (spy.count() == count) spy.wait(2000);
+        };
+
+        // Wpis ważny do "teraz" - po pełnej sekundzie jest przeterminowany
+        apiWorker.setStationsCacheMaxAge(0);
+        fetch();
+        afterFirst = server.requestCount();
+        apiWorker.setStationsCacheMaxAge(3600);
+        QTest::qWait(1100);
+        fetch();
+        afterExpired = server.requestCount();
+        fetch();
+        afterFresh = server.requestCount();
+        stationsCount = spy.count();
+    }
+    QDir::setCurrent(previousDir);
+
+    ASSERT_EQ(stationsCount, 3);
+    ASSERT_EQ(afterFirst, 1);
+    // Przeterminowany wpis: żądanie warunkowe, odpowiedź 304 i treść z cache
+    ASSERT_EQ(afterExpired, 2);
+    ASSERT_EQ(server.notModifiedCount(), 1);
+    // Odświeżony wpis jest znowu ważny - bez żądania do API
+    ASSERT_EQ(afterFresh, 2);
+}
+
+// Test indeksu miast i identyfikatorów w katalogu stacji
+TEST(StationCatalogTest, LooksUpStationsByCityAndId) {
+    QJsonArray stations = QJsonDocument::fromJson(R"([
+        {"id": 1, "stationName": "Kraków, Aleja Krasińskiego", "city": {"name": "Kraków"}},
+        {"id": 2, "stationName": "Warszawa, Marszałkowska", "city": {"name": "Warszawa"}},
+        {"id": 3, "stationName": "Kraków, Bulwarowa", "city": {"name": "Kraków"}},
+        {"id": 4, "stationName": "Bez miasta"}
+    ])").array();
+
+    StationCatalog catalog = StationCatalog::fromJson(stations);
+
+    ASSERT_EQ(catalog.size(), 3);
+    ASSERT_EQ(catalog.stationIdsInCity("Kraków"), QVector<int>({1, 3}));
+    ASSERT_EQ(catalog.stationIdsInCity("  kraków "), QVector<int>({1, 3}));
+    ASSERT_TRUE(catalog.stationIdsInCity("Gdańsk").isEmpty());
+
+    const Station *station = catalog.stationById(2);
+    ASSERT_NE(station, nullptr);
+    ASSERT_EQ(station->name, "Warszawa, Marszałkowska");
+    ASSERT_EQ(catalog.cityName(*station), "Warszawa");
+    ASSERT_EQ(catalog.stationById(4), nullptr);
+}
+
+// Test zapytań przestrzennych po współrzędnych stacji
+TEST(StationCatalogTest, FindsNearestStationsAndStationsWithinRadius) {
+    QJsonArray stations = QJsonDocument::fromJson(R"([
+        {"id": 1, "stationName": "Kraków", "city": {"name": "Kraków"}, "gegrLat": "50.057678", "gegrLon": "19.926189"},
+        {"id": 2, "stationName": "Warszawa", "city": {"name": "Warszawa"}, "gegrLat": "52.219298", "gegrLon": "21.004724"},
+        {"id": 3, "stationName": "Gdańsk", "city": {"name": "Gdańsk"}, "gegrLat": "54.380279", "gegrLon": "18.620274"},
+        {"id": 4, "stationName": "Skawina", "city": {"name": "Skawina"}, "gegrLat": "49.971271", "gegrLon": "19.830238"},
+        {"id": 5, "stationName": "Bez współrzędnych", "city": {"name": "X"}}
+    ])").array();
+    StationCatalog catalog = StationCatalog::fromJson(stations);
+
+    QVector<GeoMatch> nearest = catalog.nearestStations(50.06, 19.94, 2);
+    ASSERT_EQ(nearest.size(), 2);
+    ASSERT_EQ(nearest[0].id, 1);
+    ASSERT_EQ(nearest[1].id, 4);
+    ASSERT_LT(nearest[0].distanceKm, nearest[1].distanceKm);
+
+    // Kraków - Warszawa to ok. 252 km
+    ASSERT_NEAR(SpatialIndex::distanceKm(50.057678, 19.926189, 52.219298, 21.004724), 252.0, 3.0);
+
+    QVector<GeoMatch> within = catalog.stationsWithinRadius(50.06, 19.94, 300.0);
+    ASSERT_EQ(within.size(), 3);
+    ASSERT_EQ(within.last().id, 2);
+    ASSERT_EQ(catalog.nearestStations(50.06, 19.94, 10).size(), 4);
+}
+
+// Test zapisu i odczytu binarnego pliku serii
+TEST(SeriesFileTest, RoundTripsColumnsAndNulls) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    QJsonObject data = QJsonDocument::fromJson(R"({"key": "PM10", "values": [
+        {"date": "2025-04-27 19:00:00", "value": 10.5},
+        {"date": "2025-04-27 18:00:00", "value": null},
+        {"date": "2025-04-27 17:00:00", "value": 11.25}
+    ]})").object();
+    MeasurementSeries series = MeasurementSeries::fromJson(data, 6085);
+    ASSERT_EQ(series.size(), 3);
+    ASSERT_LT(series.timestamps[0], series.timestamps[2]);
+
+    const QString path = dir.filePath("dane_6085.bin");
+    ASSERT_TRUE(SeriesFile::write(path, series));
+
+    SeriesFile file;
+    ASSERT_TRUE(file.open(path));
+    ASSERT_EQ(file.sensorId(), 6085);
+    ASSERT_EQ(file.key(), "PM10");
+    ASSERT_EQ(file.count(), 3);
+    ASSERT_EQ(file.timestampAt(0) * 1000, series.timestamps[0]);
+    ASSERT_FLOAT_EQ(file.valueAt(0), 11.25f);
+    ASSERT_TRUE(file.isNullAt(1));
+    ASSERT_FALSE(file.isNullAt(2));
+
+    MeasurementSeries loaded = file.toSeries();
+    ASSERT_EQ(loaded.timestamps, series.timestamps);
+    ASSERT_TRUE(loaded.isNull(1));
+    ASSERT_DOUBLE_EQ(loaded.values[2], 10.5);
+}
+
+// Test dopisywania nowych pomiarów do archiwum i scalania zmienionych punktów
+TEST(SeriesFileTest, MergeAppendsNewPointsAndRewritesChangedOnes) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.filePath("dane_1.bin");
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    MeasurementSeries first;
+    first.sensorId = 1;
+    first.key = "NO2";
+    first.timestamps = {3600000, 7200000, 10800000};
+    first.values = {1.0, nan, 3.0};
+    ASSERT_TRUE(SeriesFile::merge(path, first));
+
+    // Dwa punkty bez zmian + dwa nowe: dopisany blok, bez przepisywania archiwum
+    MeasurementSeries second = first;
+    second.timestamps = {7200000, 10800000, 14400000, 18000000};
+    second.values = {nan, 3.0, 4.0, 5.0};
+    ASSERT_TRUE(SeriesFile::merge(path, second));
+    {
+        SeriesFile file;
+        ASSERT_TRUE(file.open(path));
+        ASSERT_EQ(file.count(), 5);
+        ASSERT_EQ(file.blockCount(), 2);
+        ASSERT_EQ(file.timestampAt(4), 18000);
+        ASSERT_FLOAT_EQ(file.valueAt(3), 4.0f);
+    }
+
+    // Uzupełniony brak pomiaru: archiwum scalone i zapisane od nowa
+    MeasurementSeries third = first;
+    third.timestamps = {7200000};
+    third.values = {2.0};
+    ASSERT_TRUE(SeriesFile::merge(path, third));
+
+    SeriesFile file;
+    ASSERT_TRUE(file.open(path));
+    ASSERT_EQ(file.count(), 5);
+    ASSERT_EQ(file.blockCount(), 1);
+    ASSERT_FALSE(file.isNullAt(1));
+    ASSERT_FLOAT_EQ(file.valueAt(1), 2.0f);
+}
+
+// Test dopisywania za przerwanym zapisem bloku i odkładania nieczytelnego archiwum
+TEST(SeriesFileTest, AppendAfterTornBlockAndCorruptArchive) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.filePath("dane_1.bin");
+
+    MeasurementSeries first;
+    first.sensorId = 1;
+    first.key = "NO2";
+    first.timestamps = {3600000, 7200000};
+    first.values = {1.0, 2.0};
+    ASSERT_TRUE(SeriesFile::merge(path, first));
+
+    // Przerwany zapis: blok na końcu pliku, ale licznik w nagłówku bez zmian
+    {
+        QFile file(path);
+        ASSERT_TRUE(file.open(QIODevice::Append));
+        const quint32 blockHeader[2] = {2, 0};
+        file.write(reinterpret_cast<const char *>(blockHeader), sizeof(blockHeader));
+        file.write(QByteArray(12, '\x7f'));
+    }
+
+    MeasurementSeries second = first;
+    second.timestamps = {7200000, 10800000, 14400000};
+    second.values = {2.0, 3.0, 4.0};
+    ASSERT_TRUE(SeriesFile::merge(path, second));
+    {
+        SeriesFile file;
+        ASSERT_TRUE(file.open(path));
+        ASSERT_EQ(file.count(), 4);
+        ASSERT_EQ(file.blockCount(), 2);
+        ASSERT_EQ(file.timestampAt(2), 10800);
+        ASSERT_EQ(file.timestampAt(3), 14400);
+        ASSERT_FLOAT_EQ(file.valueAt(3), 4.0f);
+    }
+
+    // Nieczytelny nagłówek: archiwum odłożone obok, nie nadpisane; kolejne uszkodzenie
+    // nie usuwa wcześniej odłożonego pliku
+    for (const QByteArray &garbage : {QByteArray("XXXX"), QByteArray("YYYY")}) {
+        QFile file(path);
+        ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+        file.write(garbage);
+        file.close();
+        ASSERT_TRUE(SeriesFile::merge(path, first));
+    }
+    const QStringList aside = QDir(dir.path()).entryList({"dane_1.bin.corrupt-*"}, QDir::Files, QDir::Name);
+    ASSERT_EQ(aside.size(), 2);
+    QSet<QByteArray> heads;
+    for (const QString &name : aside) {
+        QFile file(dir.filePath(name));
+        ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+        heads.insert(file.read(4));
+    }
+    ASSERT_EQ(heads, QSet<QByteArray>({"XXXX", "YYYY"}));
+    SeriesFile file;
+    ASSERT_TRUE(file.open(path));
+    ASSERT_EQ(file.count(), 2);
+}
+
+// Test zgodności szybkiego parsera z QDateTime, także po obu stronach zmiany czasu
+TEST(TimestampParserTest, MatchesQDateTimeAcrossDstChange) {
+    const QTimeZone warsaw("Europe/Warsaw");
+    ASSERT_TRUE(warsaw.isValid());
+    TimestampParser parser(warsaw);
+
+    for (const char *text : {"2025-03-30 01:00:00", "2025-03-30 03:00:00", "2025-04-27 19:00:00",
+                             "2025-10-26 04:00:00", "2024-02-29 23:59:59", "2025-01-01T00:00:00"}) {
+        const QString date = QString::fromLatin1(text);
+        qint64 parsed = 0;
+        ASSERT_TRUE(parser.parse(date, parsed)) << text;
+
+        QDateTime expected = QDateTime::fromString(date, Qt::ISODate);
+        expected = QDateTime(expected.date(), expected.time(), warsaw);
+        ASSERT_EQ(parsed, expected.toMSecsSinceEpoch()) << text;
+
+        qint64 parsedBytes = 0;
+        ASSERT_TRUE(parser.parse(text, qstrlen(text), parsedBytes));
+        ASSERT_EQ(parsedBytes, parsed);
+    }
+
+    // Domyślna strefa to czas polski, niezależnie od strefy systemu (np. UTC na serwerze)
+    qint64 parsedDefault = 0, parsedWarsaw = 0;
+    ASSERT_TRUE(TimestampParser().parse(u"2025-07-01 12:00:00", parsedDefault));
+    ASSERT_TRUE(parser.parse(u"2025-07-01 12:00:00", parsedWarsaw));
+    ASSERT_EQ(parsedDefault, parsedWarsaw);
+    ASSERT_TRUE(TimestampParser::parseIso("2025-07-01T12:00", parsedDefault));
+    ASSERT_EQ(parsedDefault, parsedWarsaw);
+
+    qint64 ignored;
+    ASSERT_FALSE(parser.parse(u"2025-13-01 00:00:00", ignored));
+    ASSERT_FALSE(parser.parse(u"27.04.2025 19:00", ignored));
+    // Dzień spoza miesiąca nie przechodzi na następny miesiąc
+    ASSERT_FALSE(parser.parse(u"2025-02-30 00:00:00", ignored));
+    ASSERT_FALSE(parser.parse(u"2025-02-29 00:00:00", ignored));
+    ASSERT_FALSE(parser.parse("2025-04-31 12:00:00", 19, ignored));
+
+    // Data z przesunięciem względem UTC idzie ścieżką ISO, a nie jako czas polski
+    ASSERT_FALSE(parser.parse(u"2025-01-01T00:00:00Z", ignored));
+    ASSERT_FALSE(parser.parse("2025-07-01T12:00:00+02:00", 25, ignored));
+    const QJsonObject data = QJsonDocument::fromJson(R"({"key": "PM10", "values": [
+        {"date": "2025-07-01T12:00:00+02:00", "value": 2},
+        {"date": "2025-01-01T00:00:00Z", "value": 1}
+    ]})").object();
+    const MeasurementSeries series = MeasurementSeries::fromJson(data, 1);
+    ASSERT_EQ(series.size(), 2);
+    ASSERT_EQ(series.timestamps[0], QDateTime(QDate(2025, 1, 1), QTime(0, 0), QTimeZone::UTC).toMSecsSinceEpoch());
+    ASSERT_EQ(series.timestamps[1], QDateTime(QDate(2025, 7, 1), QTime(10, 0), QTimeZone::UTC).toMSecsSinceEpoch());
+}
+
+// Test przycinania serii do zakresu dat i liczenia statystyk
+TEST(MeasurementSeriesTest, SliceComputesStatsForRange) {
+    MeasurementSeries series;
+    series.sensorId = 7;
+    series.timestamps = {1000, 2000, 3000, 4000};
+    series.values = {5.0, std::numeric_limits<double>::quiet_NaN(), 1.0, 9.0};
+
+    SeriesSlice slice = SeriesSlice::make(series, 1500, 3500);
+    ASSERT_EQ(slice.series.size(), 2);
+    ASSERT_EQ(slice.series.timestamps.first(), 2000);
+    ASSERT_EQ(slice.stats.count, 1);
+    ASSERT_DOUBLE_EQ(slice.stats.min, 1.0);
+    ASSERT_EQ(slice.stats.minTimestamp, 3000);
+
+    SeriesStats all = SeriesSlice::make(series).stats;
+    ASSERT_EQ(all.count, 3);
+    ASSERT_DOUBLE_EQ(all.max, 9.0);
+    ASSERT_DOUBLE_EQ(all.mean, 5.0);
+}
+
+// Test strumieniowego parsera danych: zgodność z parsowaniem DOM przy podziale na porcje
+TEST(SeriesStreamParserTest, MatchesDomParseAcrossChunkBoundaries) {
+    const QByteArray body = R"({"key":"PM2.5","values":[{"date":"2025-01-01 11:00:00","value":7},)"
+                            R"({"date":"2025-01-01 10:00:00","value":null}, {"date":"2025-01-01 09:00:00","value":-1.25e1}]})";
+    const MeasurementSeries expected = MeasurementSeries::fromJson(QJsonDocument::fromJson(body).object(), 5);
+
+    // Porcje po jednym bajcie przecinają każdy token
+    SeriesStreamParser parser;
+    for (char byte : body)
+        parser.feed(QByteArray(1, byte));
+    ASSERT_TRUE(parser.finish());
+    const MeasurementSeries series = parser.takeSeries(5);
+
+    ASSERT_EQ(series.key, "PM2.5");
+    ASSERT_EQ(series.timestamps, expected.timestamps);
+    ASSERT_DOUBLE_EQ(series.values[0], -12.5);
+    ASSERT_TRUE(series.isNull(1));
+    ASSERT_DOUBLE_EQ(series.values[2], 7.0);
+
+    SeriesStreamParser truncated;
+    truncated.feed(body.left(body.size() - 3));
+    ASSERT_FALSE(truncated.finish());
+    ASSERT_FALSE(truncated.errorString().isEmpty());
+}
+
+// Test decymacji LTTB: rozmiar, krańce serii i zachowanie pojedynczego skoku
+TEST(DownsamplerTest, LttbKeepsEndsAndSpikes) {
+    QList<QPointF> points;
+    for (int i = 0; i < 8760; ++i)
+        points.append(QPointF(i, i == 4000 ? 500.0 : i % 24));
+
+    QList<QPointF> sampled = Downsampler::lttb(points, 800);
+    ASSERT_EQ(sampled.size(), 800);
+    ASSERT_EQ(sampled.first(), points.first());
+    ASSERT_EQ(sampled.last(), points.last());
+    ASSERT_TRUE(sampled.contains(QPointF(4000, 500.0)));
+
+    ASSERT_EQ(Downsampler::lttb(points, 10000).size(), points.size());
+
+    QList<QPointF> visible = Downsampler::visible(points, 100.5, 200.5);
+    ASSERT_EQ(visible.first().x(), 100);
+    ASSERT_EQ(visible.last().x(), 201);
+}
+
+// Test modelu tabeli pomiarów: liczba wierszy i formatowanie w data()
+TEST(MeasurementTableModelTest, FormatsRowsOnDemand) {
+    MeasurementSeries series;
+    series.timestamps = {QDateTime(QDate(2025, 1, 1), QTime(10, 0)).toMSecsSinceEpoch(),
+                         QDateTime(QDate(2025, 1, 1), QTime(11, 0)).toMSecsSinceEpoch()};
+    series.values = {12.5, std::numeric_limits<double>::quiet_NaN()};
+
+    MeasurementTableModel model;
+    model.setSeries(series);
+
+    ASSERT_EQ(model.rowCount(), 2);
+    ASSERT_EQ(model.columnCount(), 2);
+    ASSERT_EQ(model.data(model.index(0, MeasurementTableModel::DateColumn)).toString(), "01.01.2025 10:00");
+    ASSERT_EQ(model.data(model.index(0, MeasurementTableModel::ValueColumn)).toString(), "12.5");
+    ASSERT_EQ(model.data(model.index(1, MeasurementTableModel::ValueColumn)).toString(), "brak danych");
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,121 @@
+#include "timestampparser.h"
+#include <QDateTime>
+#include <limits>
+
+namespace {
+
+// Liczba dni od 1970-01-01 dla daty kalendarza gregoriańskiego (algorytm H. Hinnanta)
+qint64 daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const int yearOfEra = year - era * 400;
+    const int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return qint64(era) * 146097 + dayOfEra - 719468;
+}
+
+template <typename Char>
+int digit(Char c) {
+    const int value = int(c) - '0';
+    return (value >= 0 && value <= 9) ? value : -1;
+}
+
+template <typename Char>
+bool readNumber(const Char *text, int count, int &value) {
+    value = 0;
+    for (int i = 0; i < count; ++i) {
+        const int d = digit(text[i]);
+        if (d < 0) return false;
+        value = value * 10 + d;
+    }
+    return true;
+}
+
+int daysInMonth(int year, int month) {
+    static const int days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    const bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return month == 2 && leap ? 29 : days[month - 1];
+}
+
+// Odczyt pól "yyyy-MM-dd HH:mm:ss" do sekund czasu lokalnego od epoki. Tekst z czymkolwiek
+// za sekundami (strefa "Z", "+02:00", ułamki sekund) zostaje dla parseIso().
+template <typename Char>
+bool parseLocalSecs(const Char *text, qsizetype length, qint64 &localSecs) {
+    if (length != 19) return false;
+    if (text[4] != '-' || text[7] != '-' || (text[10] != ' ' && text[10] != 'T')
+        || text[13] != ':' || text[16] != ':')
+        return false;
+
+    int year, month, day, hour, minute, second;
+    if (!readNumber(text, 4, year) || !readNumber(text + 5, 2, month) || !readNumber(text + 8, 2, day)
+        || !readNumber(text + 11, 2, hour) || !readNumber(text + 14, 2, minute)
+        || !readNumber(text + 17, 2, second))
+        return false;
+    if (month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month)
+        || hour > 23 || minute > 59 || second > 59)
+        return false;
+
+    localSecs = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+    return true;
+}
+
+} // namespace
+
+QTimeZone TimestampParser::apiTimeZone() {
+    // Serwer z trybem wsadowym zwykle działa w UTC - daty API są jednak zawsze w czasie polskim
+    static const QTimeZone warsaw("Europe/Warsaw");
+    return warsaw.isValid() ? warsaw : QTimeZone::systemTimeZone();
+}
+
+TimestampParser::TimestampParser(const QTimeZone &zone) : zone(zone) {}
+
+bool TimestampParser::parseIso(const QString &text, qint64 &msecsSinceEpoch) {
+    QDateTime dateTime = QDateTime::fromString(text, Qt::ISODate);
+    if (!dateTime.isValid()) return false;
+    if (dateTime.timeSpec() == Qt::LocalTime)
+        dateTime = QDateTime(dateTime.date(), dateTime.time(), apiTimeZone());
+    msecsSinceEpoch = dateTime.toMSecsSinceEpoch();
+    return true;
+}
+
+bool TimestampParser::parse(const char *text, qsizetype length, qint64 &msecsSinceEpoch) {
+    qint64 localSecs;
+    if (!parseLocalSecs(text, length, localSecs)) return false;
+    msecsSinceEpoch = toUtc(localSecs) * 1000;
+    return true;
+}
+
+bool TimestampParser::parse(QStringView text, qint64 &msecsSinceEpoch) {
+    qint64 localSecs;
+    if (!parseLocalSecs(text.utf16(), text.size(), localSecs)) return false;
+    msecsSinceEpoch = toUtc(localSecs) * 1000;
+    return true;
+}
+
+qint64 TimestampParser::toUtc(qint64 localSecs) {
+    if (localSecs >= cachedFrom && localSecs < cachedTo)
+        return localSecs - cachedOffset;
+
+    // Pełne wyznaczenie przesunięcia tylko poza zapamiętanym przedziałem
+    const QDateTime naive = QDateTime::fromSecsSinceEpoch(localSecs, QTimeZone::UTC);
+    const QDateTime local(naive.date(), naive.time(), zone);
+    cachedOffset = local.offsetFromUtc();
+
+    const qint64 utc = localSecs - cachedOffset;
+    if (!zone.hasTransitions()) {
+        // Bez listy zmian czasu zapamiętujemy przesunięcie tylko dla bieżącej godziny
+        cachedFrom = localSecs - localSecs % 3600;
+        cachedTo = cachedFrom + 3600;
+        return utc;
+    }
+
+    // Przedział, w którym przesunięcie jest stałe: od poprzedniej do następnej zmiany czasu
+    const QDateTime instant = QDateTime::fromSecsSinceEpoch(utc, QTimeZone::UTC);
+    const QTimeZone::OffsetData previous = zone.previousTransition(instant.addSecs(1));
+    const QTimeZone::OffsetData next = zone.nextTransition(instant);
+    cachedFrom = previous.atUtc.isValid() ? previous.atUtc.toSecsSinceEpoch() + cachedOffset
+                                          : std::numeric_limits<qint64>::min();
+    cachedTo = next.atUtc.isValid() ? next.atUtc.toSecsSinceEpoch() + cachedOffset
+                                    : std::numeric_limits<qint64>::max();
+    return utc;
+}
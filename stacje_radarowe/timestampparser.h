@@ -0,0 +1,76 @@
+#ifndef TIMESTAMPPARSER_H
+#define TIMESTAMPPARSER_H
+
+#include <QStringView>
+#include <QTimeZone>
+
+/**
+ * @class TimestampParser
+ * @brief Szybki parser znaczników czasu GIOŚ w stałym formacie "yyyy-MM-dd HH:mm:ss".
+ *
+ * Zamienia tekst bezpośrednio na milisekundy od epoki: cyfry czytane są z pozycji,
+ * a data zamieniana na dni arytmetycznie, bez alokacji i bez QDateTime w pętli.
+ * Przesunięcie strefy czasowej jest wyznaczane przez QTimeZone tylko raz dla całego
+ * przedziału między zmianami czasu (letni/zimowy) i zapamiętywane, więc seria
+ * pomiarów z roku kosztuje dwa-trzy zapytania o strefę zamiast jednego na punkt.
+ *
+ * Obiekt przechowuje pamięć podręczną przesunięcia, więc nie jest bezpieczny
+ * do równoczesnego użycia z wielu wątków - każdy wątek powinien mieć własny.
+ */
+class TimestampParser {
+public:
+    /**
+     * @brief Strefa czasowa dat GIOŚ: czas polski (Europe/Warsaw), niezależnie od strefy systemu.
+     *
+     * Bez bazy stref czasowych w systemie zwraca strefę systemową.
+     */
+    static QTimeZone apiTimeZone();
+
+    /**
+     * @brief Konstruktor klasy TimestampParser.
+     * @param zone Strefa czasowa, w której API podaje czas (domyślnie apiTimeZone()).
+     */
+    explicit TimestampParser(const QTimeZone &zone = apiTimeZone());
+
+    /**
+     * @brief Parsuje znacznik czasu z bufora bajtów (np. surowej odpowiedzi HTTP).
+     * @param text Początek tekstu.
+     * @param length Długość tekstu w bajtach.
+     * @param msecsSinceEpoch Wynik w milisekundach od epoki (UTC).
+     * @return true, jeśli tekst ma dokładnie oczekiwany format i jest poprawną datą.
+     */
+    bool parse(const char *text, qsizetype length, qint64 &msecsSinceEpoch);
+
+    /**
+     * @brief Parsuje znacznik czasu z tekstu.
+     * @param text Tekst w formacie "yyyy-MM-dd HH:mm:ss" (dopuszczalne też "T" zamiast spacji).
+     * @param msecsSinceEpoch Wynik w milisekundach od epoki (UTC).
+     * @return true, jeśli tekst ma dokładnie oczekiwany format i jest poprawną datą.
+     */
+    bool parse(QStringView text, qint64 &msecsSinceEpoch);
+
+    /**
+     * @brief Wolniejsza, ogólna ścieżka dla innych zapisów ISO 8601 (QDateTime::fromString).
+     *
+     * Czas bez przesunięcia względem UTC jest interpretowany w apiTimeZone().
+     * @param text Tekst daty.
+     * @param msecsSinceEpoch Wynik w milisekundach od epoki (UTC).
+     * @return true, jeśli tekst jest poprawną datą ISO 8601.
+     */
+    static bool parseIso(const QString &text, qint64 &msecsSinceEpoch);
+
+private:
+    /**
+     * @brief Zamienia czas lokalny (liczony jak UTC) na UTC, korzystając z zapamiętanego przesunięcia.
+     * @param localSecs Sekundy od epoki czasu lokalnego.
+     * @return Sekundy od epoki UTC.
+     */
+    qint64 toUtc(qint64 localSecs);
+
+    QTimeZone zone;          /**< Strefa czasowa danych. */
+    qint64 cachedFrom = 1;   /**< Początek przedziału czasu lokalnego z ważnym przesunięciem. */
+    qint64 cachedTo = 0;     /**< Koniec (wyłącznie) tego przedziału. */
+    int cachedOffset = 0;    /**< Przesunięcie względem UTC w sekundach. */
+};
+
+#endif // TIMESTAMPPARSER_H
@@ -0,0 +1,239 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QTimeZone>
+#include <algorithm>
+#include <cmath>
+
+// Generator syntetycznych odpowiedzi API GIOŚ (station/findAll, station/sensors/<id>,
+// data/getData/<id>) w skali większej niż publiczne API. Pliki trafiają do drzewa
+// odpowiadającego ścieżkom URL, np. <wyjście>/pjp-api/rest/data/getData/1001.
+
+namespace {
+
+struct City {
+    const char *name;
+    const char *district;
+    const char *province;
+    double lat;
+    double lon;
+};
+
+const City kCities[] = {
+    {"Warszawa", "Warszawa", "MAZOWIECKIE", 52.2297, 21.0122},
+    {"Kraków", "Kraków", "MAŁOPOLSKIE", 50.0647, 19.9450},
+    {"Łódź", "Łódź", "ŁÓDZKIE", 51.7592, 19.4560},
+    {"Wrocław", "Wrocław", "DOLNOŚLĄSKIE", 51.1079, 17.0385},
+    {"Poznań", "Poznań", "WIELKOPOLSKIE", 52.4064, 16.9252},
+    {"Gdańsk", "Gdańsk", "POMORSKIE", 54.3520, 18.6466},
+    {"Szczecin", "Szczecin", "ZACHODNIOPOMORSKIE", 53.4285, 14.5528},
+    {"Bydgoszcz", "Bydgoszcz", "KUJAWSKO-POMORSKIE", 53.1235, 18.0084},
+    {"Lublin", "Lublin", "LUBELSKIE", 51.2465, 22.5684},
+    {"Białystok", "Białystok", "PODLASKIE", 53.1325, 23.1688},
+    {"Katowice", "Katowice", "ŚLĄSKIE", 50.2649, 19.0238},
+    {"Rzeszów", "Rzeszów", "PODKARPACKIE", 50.0412, 21.9991},
+    {"Kielce", "Kielce", "ŚWIĘTOKRZYSKIE", 50.8661, 20.6286},
+    {"Olsztyn", "Olsztyn", "WARMIŃSKO-MAZURSKIE", 53.7784, 20.4801},
+    {"Opole", "Opole", "OPOLSKIE", 50.6751, 17.9213},
+    {"Zielona Góra", "Zielona Góra", "LUBUSKIE", 51.9356, 15.5062},
+};
+
+struct Param {
+    int idParam;
+    const char *code;
+    const char *name;
+    double base;      // typowy poziom
+    double seasonal;  // amplituda zmian rocznych (zima wyżej dla pyłów)
+    double daily;     // amplituda zmian dobowych
+};
+
+const Param kParams[] = {
+    {3, "PM10", "pył zawieszony PM10", 25.0, 12.0, 6.0},
+    {69, "PM2.5", "pył zawieszony PM2.5", 16.0, 9.0, 4.0},
+    {6, "NO2", "dwutlenek azotu", 20.0, 6.0, 8.0},
+    {5, "O3", "ozon", 50.0, -20.0, 15.0},
+    {1, "SO2", "dwutlenek siarki", 5.0, 3.0, 1.0},
+    {8, "CO", "tlenek węgla", 400.0, 150.0, 80.0},
+    {10, "C6H6", "benzen", 1.2, 0.8, 0.3},
+};
+
+const int kCityCount = int(sizeof(kCities) / sizeof(kCities[0]));
+const int kParamCount = int(sizeof(kParams) / sizeof(kParams[0]));
+const double kPi = 3.14159265358979323846;
+
+bool writeFile(const QString &path, const QByteArray &content) {
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    return file.write(content) == content.size();
+}
+
+// Seria godzinowa w kształcie getData: najnowszy pomiar pierwszy, braki jako null,
+// braki występują seriami (awarie analizatora), a nie pojedynczo.
+QByteArray dataJson(const Param &param, const QDateTime &end, int hours, double nullRate, QRandomGenerator &rng) {
+    QByteArray out;
+    out.reserve(hours * 48 + 64);
+    out += "{\"key\":\"";
+    out += param.code;
+    out += "\",\"values\":[";
+
+    int gapLeft = 0;
+    const double gapStart = nullRate / 12.0; // średnia długość przerwy ~12 h
+    for (int i = 0; i < hours; ++i) {
+        const QDateTime time = end.addSecs(-3600LL * i);
+        if (i > 0) out += ',';
+        out += "{\"date\":\"";
+        out += time.toString("yyyy-MM-dd HH:mm:ss").toLatin1();
+        out += "\",\"value\":";
+
+        if (gapLeft == 0 && rng.generateDouble() < gapStart)
+            gapLeft = 1 + rng.bounded(24);
+        if (gapLeft > 0) {
+            --gapLeft;
+            out += "null}";
+            continue;
+        }
+
+        const double dayOfYear = time.date().dayOfYear();
+        const double hour = time.time().hour();
+        double value = param.base
+                       + param.seasonal * std::cos(2.0 * kPi * dayOfYear / 365.25)
+                       + param.daily * std::sin(2.0 * kPi * (hour - 6.0) / 24.0)
+                       + param.base * 0.3 * (rng.generateDouble() - 0.5);
+        value = std::max(0.0, std::round(value * 10.0) / 10.0);
+        out += QByteArray::number(value, 'f', 1);
+        out += '}';
+    }
+    out += "]}";
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("generate_dataset");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Generuje syntetyczne odpowiedzi API GIOŚ do testów w dużej skali.");
+    parser.addHelpOption();
+    QCommandLineOption outputOption({"o", "output"}, "Katalog wyjściowy.", "katalog", "dataset");
+    QCommandLineOption stationsOption("stations", "Liczba stacji.", "n", "1000");
+    QCommandLineOption sensorsOption("sensors", "Maksymalna liczba sensorów na stację (1-7).", "n", "4");
+    QCommandLineOption yearsOption("years", "Długość serii godzinowych w latach.", "n", "1");
+    QCommandLineOption dataStationsOption("data-stations", "Dla ilu pierwszych stacji generować getData (domyślnie wszystkich).", "n");
+    QCommandLineOption nullRateOption("null-rate", "Udział braków danych (0-1).", "p", "0.03");
+    QCommandLineOption seedOption("seed", "Ziarno generatora (powtarzalne dane).", "n", "1");
+    QCommandLineOption endOption("end", "Ostatni pomiar (yyyy-MM-dd HH:mm:ss), domyślnie bieżąca pełna godzina.", "data");
+    parser.addOptions({outputOption, stationsOption, sensorsOption, yearsOption, dataStationsOption,
+                       nullRateOption, seedOption, endOption});
+    parser.process(app);
+
+    QTextStream err(stderr);
+    const int stationCount = parser.value(stationsOption).toInt();
+    const int maxSensors = qBound(1, parser.value(sensorsOption).toInt(), kParamCount);
+    const int hours = int(parser.value(yearsOption).toDouble() * 365.25 * 24);
+    const int dataStations = parser.isSet(dataStationsOption) ? parser.value(dataStationsOption).toInt() : stationCount;
+    const double nullRate = qBound(0.0, parser.value(nullRateOption).toDouble(), 1.0);
+    if (stationCount <= 0 || hours <= 0) {
+        err << "Invalid --stations or --years" << Qt::endl;
+        return 1;
+    }
+
+    // Daty GIOŚ są w czasie polskim, niezależnie od strefy maszyny generującej dane
+    const QTimeZone warsaw("Europe/Warsaw");
+    QDateTime end = QDateTime::currentDateTime(warsaw);
+    end.setTime(QTime(end.time().hour(), 0));
+    if (parser.isSet(endOption)) {
+        end = QDateTime::fromString(parser.value(endOption), "yyyy-MM-dd HH:mm:ss");
+        end = QDateTime(end.date(), end.time(), warsaw);
+        if (!end.isValid()) {
+            err << "Invalid --end: " << parser.value(endOption) << Qt::endl;
+            return 1;
+        }
+    }
+
+    QRandomGenerator rng(parser.value(seedOption).toUInt());
+    const QString root = parser.value(outputOption) + "/pjp-api/rest/";
+
+    QJsonArray stations;
+    int nextSensorId = 100000;
+    qint64 valueCount = 0;
+
+    for (int s = 0; s < stationCount; ++s) {
+        const City &city = kCities[s % kCityCount];
+        const int stationId = 10000 + s;
+
+        QJsonObject commune;
+        commune["communeName"] = city.name;
+        commune["districtName"] = city.district;
+        commune["provinceName"] = city.province;
+        QJsonObject cityObject;
+        cityObject["id"] = 1 + s % kCityCount;
+        cityObject["name"] = city.name;
+        cityObject["commune"] = commune;
+
+        QJsonObject station;
+        station["id"] = stationId;
+        station["stationName"] = QString("%1, Stacja %2").arg(city.name).arg(s / kCityCount + 1);
+        station["gegrLat"] = QString::number(city.lat + (rng.generateDouble() - 0.5) * 0.2, 'f', 6);
+        station["gegrLon"] = QString::number(city.lon + (rng.generateDouble() - 0.5) * 0.3, 'f', 6);
+        station["city"] = cityObject;
+        station["addressStreet"] = QString("ul. Pomiarowa %1").arg(s + 1);
+        stations.append(station);
+
+        // Sensory: kolejne parametry od losowego przesunięcia, 1..maxSensors na stację
+        QJsonArray sensors;
+        const int sensorCount = 1 + rng.bounded(maxSensors);
+        const int offset = rng.bounded(kParamCount);
+        for (int k = 0; k < sensorCount; ++k) {
+            const Param &param = kParams[(offset + k) % kParamCount];
+            const int sensorId = nextSensorId++;
+
+            QJsonObject paramObject;
+            paramObject["idParam"] = param.idParam;
+            paramObject["paramCode"] = param.code;
+            paramObject["paramFormula"] = param.code;
+            paramObject["paramName"] = param.name;
+            QJsonObject sensor;
+            sensor["id"] = sensorId;
+            sensor["stationId"] = stationId;
+            sensor["param"] = paramObject;
+            sensors.append(sensor);
+
+            if (s < dataStations) {
+                if (!writeFile(root + "data/getData/" + QString::number(sensorId),
+                               dataJson(param, end, hours, nullRate, rng))) {
+                    err << "Cannot write data for sensor " << sensorId << Qt::endl;
+                    return 2;
+                }
+                valueCount += hours;
+            }
+        }
+
+        if (!writeFile(root + "station/sensors/" + QString::number(stationId),
+                       QJsonDocument(sensors).toJson(QJsonDocument::Compact))) {
+            err << "Cannot write sensors for station " << stationId << Qt::endl;
+            return 2;
+        }
+    }
+
+    if (!writeFile(root + "station/findAll", QJsonDocument(stations).toJson(QJsonDocument::Compact))) {
+        err << "Cannot write station list" << Qt::endl;
+        return 2;
+    }
+
+    err << "Generated " << stationCount << " stations, " << (nextSensorId - 100000) << " sensors, "
+        << valueCount << " values in " << parser.value(outputOption) << Qt::endl;
+    return 0;
+}
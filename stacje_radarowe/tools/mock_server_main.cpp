@@ -0,0 +1,63 @@
+#include "mockgiosserver.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include <QTimer>
+
+// Lokalny serwer udający API GIOŚ. Adres bazowy wypisywany na starcie należy przekazać
+// aplikacji (np. stacje_radarowe_cli --base-url ...), a statystyki co sekundę pokazują
+// liczbę żądań, przepustowość i maksymalną liczbę żądań obsługiwanych naraz.
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("mock_gios_server");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Lokalny serwer HTTP udający API GIOŚ.");
+    parser.addHelpOption();
+    QCommandLineOption portOption({"p", "port"}, "Port (0 = dowolny wolny).", "port", "8080");
+    QCommandLineOption latencyOption("latency", "Opóźnienie odpowiedzi w ms.", "ms", "0");
+    QCommandLineOption jitterOption("jitter", "Losowy dodatek do opóźnienia w ms.", "ms", "0");
+    QCommandLineOption errorRateOption("error-rate", "Odsetek odpowiedzi 503 (0-1).", "p", "0");
+    QCommandLineOption stationsOption("stations", "Liczba stacji.", "n", "50");
+    QCommandLineOption sensorsOption("sensors", "Liczba sensorów na stację.", "n", "3");
+    QCommandLineOption pointsOption("points", "Liczba pomiarów godzinowych w getData.", "n", "72");
+    QCommandLineOption datasetOption("dataset", "Katalog z generate_dataset zamiast danych generowanych.", "katalog");
+    parser.addOptions({portOption, latencyOption, jitterOption, errorRateOption, stationsOption,
+                       sensorsOption, pointsOption, datasetOption});
+    parser.process(app);
+
+    MockGiosServer server;
+    server.setLatency(parser.value(latencyOption).toInt());
+    server.setJitter(parser.value(jitterOption).toInt());
+    server.setErrorRate(parser.value(errorRateOption).toDouble());
+    server.setStationCount(parser.value(stationsOption).toInt());
+    server.setSensorsPerStation(parser.value(sensorsOption).toInt());
+    server.setDataPoints(parser.value(pointsOption).toInt());
+    if (parser.isSet(datasetOption))
+        server.setDatasetDirectory(parser.value(datasetOption));
+
+    QTextStream out(stdout);
+    if (!server.start(quint16(parser.value(portOption).toUInt()))) {
+        QTextStream(stderr) << "Cannot listen: " << server.errorString() << Qt::endl;
+        return 1;
+    }
+    out << "Base URL: " << server.baseUrl().toString() << Qt::endl;
+
+    int lastRequests = 0;
+    qint64 lastBytes = 0;
+    QTimer stats;
+    QObject::connect(&stats, &QTimer::timeout, &server, [&]() {
+        if (server.requestCount() == lastRequests) return;
+        out << "requests: " << server.requestCount()
+            << ", req/s: " << (server.requestCount() - lastRequests)
+            << ", KiB/s: " << (server.bytesSent() - lastBytes) / 1024
+            << ", max concurrent: " << server.maxConcurrentRequests() << Qt::endl;
+        lastRequests = server.requestCount();
+        lastBytes = server.bytesSent();
+    });
+    stats.start(1000);
+
+    return app.exec();
+}